@@ -0,0 +1,87 @@
+// #############################################
+// ####### Bench10: metadata wear ##############
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// A log that is cleared often (initialize(1, ...), lazy format)
+// and a small counter (1 byte, frequent counter rollovers).
+// Output per round: bytes written in total and to metadata, and
+// metaWear(): write cycles of the most worn metadata cell.
+//
+// Compare both builds (EEProm_Safe_Wear_Level_Macros.h):
+//  #define EEPRWL_META_RING 0   (default, fixed cells)
+//  #define EEPRWL_META_RING 8   (metadata ring with 8 slots)
+//
+// REQUIREMENT: Uncomment '#define EEPRWL_IO_STATS' in
+// EEProm_Safe_Wear_Level_Macros.h, otherwise the write counters
+// do not exist.
+//
+// WARNING: The partition is formatted and written to many times.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+#ifndef EEPRWL_IO_STATS
+  #error "Enable EEPRWL_IO_STATS in EEProm_Safe_Wear_Level_Macros.h"
+#endif
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  1
+#define WRITE_CYCLES_PER_HOUR 255
+#define HANDLE1  0
+#define ROUNDS   10
+
+//Offset Definitions for PartitionsData
+#define numberOfSectors 8
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+uint16_t value;
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench10: metadata wear                      ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.print(F("EEPRWL_META_RING: ")); Serial.println(EEPRWL_META_RING);
+
+    EEPRWL.config(0, 256, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+    Serial.println(F("round\tbytes\tmetadata\tovw counter\tmetaWear"));
+
+    for (uint8_t r = 1; r <= ROUNDS; r++) {
+        // Six laps (a counter rollover), then the log is cleared
+        for (value = 1; value <= 6 * sectors; value++) EEPRWL.write(value, HANDLE1);
+        EEPRWL.initialize(1, HANDLE1);
+
+        Serial.print(r); Serial.print('\t');
+        Serial.print(EEPRWL_ioWrites); Serial.print('\t');
+        Serial.print(EEPRWL_metaWrites); Serial.print("\t\t");
+        Serial.print(EEPRWL.getOverwCounter(HANDLE1)); Serial.print("\t\t");
+        Serial.println(EEPRWL.metaWear(HANDLE1));
+    }
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
@@ -0,0 +1,143 @@
+// #############################################
+// ####### Bench11: sector ECC #################
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// 1. CPU cycles per byte of the SEC-DED code against the default
+//    checksum (CRC-8 nibble) for the sector sizes of Bench2:
+//    encode (every write), check without error (only after a
+//    checksum error in the library) and correction of one bit.
+// 2. A log on a simulated EEPROM (EEPRWL_RamStorage): one bit of
+//    every sector is flipped, then the log is read back. Output:
+//    records read, eccCorrected(), eccUncorrectable() and the
+//    time of the read loop.
+//
+// Compare both builds (EEProm_Safe_Wear_Level_Macros.h):
+//  #define EEPRWL_ECC 0   (default, a flipped bit loses the record)
+//  #define EEPRWL_ECC 1   (check word per sector, 2 bytes)
+//
+// No EEPROM access takes place in this sketch.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define ITERATIONS 500
+#define MEMORY_SIZE 512
+#define HANDLE1     0
+
+// Checksummed bytes per sector (see Bench2)
+const uint8_t sizes[] = {3, 4, 5, 8, 10, 11, 13, 34};
+
+uint8_t buffer[34];
+volatile uint16_t sink;   // keeps the compiler from removing the loops
+
+//Offset Definitions for PartitionsData
+#define numberOfSectors 8
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+uint8_t memory[MEMORY_SIZE];
+EEPRWL_RamStorage storage(memory, MEMORY_SIZE);
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data, storage);
+
+uint32_t value;
+
+// ----------------------------------------------------
+// --- HELPER ---
+// ----------------------------------------------------
+
+void printCycles(uint32_t us, uint8_t len) {
+    // cycles per byte with one decimal place
+    uint32_t c10 = (us * (F_CPU / 100000UL)) / ((uint32_t)ITERATIONS * len);
+    Serial.print(c10 / 10); Serial.print('.'); Serial.print(c10 % 10);
+    Serial.print('\t');
+}
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench11: sector ECC                         ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.print(F("EEPRWL_ECC: ")); Serial.println(EEPRWL_ECC);
+
+    // --- 1. Cycles per byte ---
+    Serial.println(F("bytes\tNIBBLE\tENCODE\tCHECK\tCORRECT"));
+    for (uint8_t i = 0; i < sizeof(buffer); i++) buffer[i] = i * 37 + 11;
+
+    for (uint8_t s = 0; s < sizeof(sizes); s++) {
+        uint8_t len = sizes[s];
+        uint16_t check = eeprwlEcc(buffer, len);
+        uint16_t c;
+        uint32_t t;
+        uint16_t i;
+
+        Serial.print(len); Serial.print('\t');
+
+        t = micros();
+        for (i = 0; i < ITERATIONS; i++) sink = eeprwlCrc8Nibble(buffer, len);
+        printCycles(micros() - t, len);
+
+        t = micros();
+        for (i = 0; i < ITERATIONS; i++) sink = eeprwlEcc(buffer, len);
+        printCycles(micros() - t, len);
+
+        t = micros();
+        for (i = 0; i < ITERATIONS; i++) { c = check; sink = eeprwlEccCorrect(buffer, len, c); }
+        printCycles(micros() - t, len);
+
+        // One flipped bit, corrected again by every call
+        t = micros();
+        for (i = 0; i < ITERATIONS; i++) {
+            buffer[len / 2] ^= 0x04;
+            c = check; sink = eeprwlEccCorrect(buffer, len, c);
+        }
+        printCycles(micros() - t, len);
+
+        Serial.println();
+    }
+
+    // --- 2. Log with one flipped bit per sector ---
+    memset(memory, 0xFF, sizeof(memory));   // erased EEPROM
+    EEPRWL.config(0, MEMORY_SIZE - 16, sizeof(value), 3, 255, HANDLE1);
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+    for (value = 1; value <= sectors; value++) EEPRWL.write(value, HANDLE1);
+
+    // Sector size: payload, counter, check word and checksum
+    uint16_t secSize = sizeof(value) + 3 + ECC_LEN + CRC_LEN;
+    for (uint16_t k = 0; k < sectors; k++) memory[METADATA_SIZE + k * secSize + k % secSize] ^= 1 << (k & 7);
+
+    uint16_t found = 0;
+    uint32_t t = micros();
+    for (uint16_t k = 0; k < sectors; k++) {
+        if (EEPRWL.readRelative(-(int32_t)k, value, HANDLE1) && value == sectors - k) found++;
+    }
+    t = micros() - t;
+
+    Serial.print(F("Records read: ")); Serial.print(found); Serial.print('/'); Serial.println(sectors);
+    Serial.print(F("eccCorrected(): ")); Serial.print(EEPRWL.eccCorrected());
+    Serial.print(F(", eccUncorrectable(): ")); Serial.println(EEPRWL.eccUncorrectable());
+    Serial.print(F("Read loop [us]: ")); Serial.println(t);
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
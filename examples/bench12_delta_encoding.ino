@@ -0,0 +1,133 @@
+// #############################################
+// ####### Bench12: delta encoding #############
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// Two partitions of the same size on a simulated EEPROM
+// (EEPRWL_RamStorage) store the same slowly changing struct of
+// 24 bytes (a runtime counter and now and then a setpoint):
+//  - HANDLE_PLAIN (1): payload 24 bytes, one sector per record
+//  - HANDLE_DELTA (0): payload 6 bytes, delta encoding with a
+//    keyframe every KEYFRAME_EVERY records
+// Output per round: sectors of the ring, sectors written, sector
+// writes per cell (sectors written / sectors of the ring, the
+// wear of the partition) and whether read(0) returns the record.
+// At the end the delta partition is read back after a restart.
+//
+// REQUIREMENT: '#define EEPRWL_DELTA 1' (or more) in
+// EEProm_Safe_Wear_Level_Macros.h.
+//
+// No EEPROM access takes place in this sketch.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+#if EEPRWL_DELTA < 1
+  #error "Set EEPRWL_DELTA 1 in EEProm_Safe_Wear_Level_Macros.h"
+#endif
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define MEMORY_SIZE   1024
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 255
+#define HANDLE_DELTA  0
+#define HANDLE_PLAIN  1
+#define KEYFRAME_EVERY 16
+#define ROUNDS        5
+#define RECORDS       200
+
+//Offset Definitions for PartitionsData
+#define actLogicalSector 0
+#define numberOfSectors 8
+
+typedef struct {
+    uint8_t data[16 * 2];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+uint8_t memory[MEMORY_SIZE];
+EEPRWL_RamStorage storage(memory, MEMORY_SIZE);
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data, storage);
+
+struct Settings {
+    uint32_t runtime;         // changes with every record
+    int16_t  setpoint;        // changes every 25 records
+    uint8_t  mode;
+    uint8_t  flags;
+    char     name[16];
+} settings = {0, 215, 1, 0, "Boiler 1"};
+
+// ----------------------------------------------------
+// --- HELPER ---
+// ----------------------------------------------------
+
+void printPartition(uint8_t handle) {
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, handle);
+    uint32_t written = EEPRWL.getCtrlData(actLogicalSector, handle);
+    Settings check;
+    bool match = EEPRWL.read(0, check, handle) && memcmp(&check, &settings, sizeof(settings)) == 0;
+
+    Serial.print(sectors); Serial.print('\t');
+    Serial.print(written); Serial.print('\t');
+    // sector writes per cell with one decimal place
+    Serial.print(written / sectors); Serial.print('.'); Serial.print((written * 10 / sectors) % 10);
+    Serial.print('\t');
+    Serial.print(match ? F("ok") : F("FAIL")); Serial.print('\t');
+}
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench12: delta encoding                     ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    memset(memory, 0xFF, sizeof(memory));   // erased EEPROM
+    EEPRWL.config(0, 500, 6, COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE_DELTA);
+    EEPRWL.config(500, 500, sizeof(settings), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE_PLAIN);
+    EEPRWL.setDelta(true, KEYFRAME_EVERY, HANDLE_DELTA);
+
+    Serial.println(F("\tDELTA\t\t\t\tPLAIN"));
+    Serial.println(F("records\tsectors\twritten\tper cell\tread(0)\tsectors\twritten\tper cell\tread(0)"));
+
+    uint32_t records = 0;
+    for (uint8_t r = 1; r <= ROUNDS; r++) {
+        for (uint16_t i = 0; i < RECORDS; i++) {
+            settings.runtime++;
+            if (settings.runtime % 25 == 0) settings.setpoint += 5;
+            EEPRWL.write(settings, HANDLE_DELTA);
+            EEPRWL.write(settings, HANDLE_PLAIN);
+            records++;
+        }
+        Serial.print(records); Serial.print('\t');
+        printPartition(HANDLE_DELTA);
+        printPartition(HANDLE_PLAIN);
+        Serial.println();
+    }
+
+    // Restart: read(0) rebuilds the record from the keyframe and the deltas
+    EEProm_Safe_Wear_Level restarted(PartitionsData.data, storage);
+    restarted.config(0, 500, 6, COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE_DELTA);
+    restarted.setDelta(true, KEYFRAME_EVERY, HANDLE_DELTA);
+    Settings check;
+    bool match = restarted.read(0, check, HANDLE_DELTA) && memcmp(&check, &settings, sizeof(settings)) == 0;
+    Serial.print(F("After restart, read(0): ")); Serial.println(match ? F("ok") : F("FAIL"));
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
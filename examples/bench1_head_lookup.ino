@@ -0,0 +1,110 @@
+// #############################################
+// ######## Bench1: head lookup (boot) #########
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// Compares the EEPROM read accesses of the head lookup used by
+// config(), findNewestData(), findOldestData() and read modes 3/4
+// with a full partition scan (every sector read and CRC checked,
+// as the library did before the binary search was introduced).
+//
+// REQUIREMENT: Uncomment '#define EEPRWL_IO_STATS' in
+// EEProm_Safe_Wear_Level_Macros.h, otherwise the read counter
+// does not exist.
+//
+// WARNING: The partition is formatted and written to many times.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+#ifndef EEPRWL_IO_STATS
+  #error "Enable EEPRWL_IO_STATS in EEProm_Safe_Wear_Level_Macros.h"
+#endif
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  2
+#define PART_CNT 1
+#define HANDLE1  0
+#define WRITE_CYCLES_PER_HOUR 255
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0 // Counter for the total number of sectors written
+#define numberOfSectors 8       // Total number of available sectors in the partition
+
+typedef struct {
+    uint8_t data[16 * PART_CNT];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL_Main(PartitionsData.data);
+
+// Partition: 2 byte payload on (almost) the complete EEPROM
+#define ADDR1 0
+#define SIZE1 (EEPROM.length() - 16)
+#define PAYLOAD_SIZE 2
+
+// ----------------------------------------------------
+// --- HELPER ---
+// ----------------------------------------------------
+
+void measure(uint16_t records) {
+    uint16_t sectors = EEPRWL_Main.getCtrlData(numberOfSectors, HANDLE1);
+    uint32_t fast, linear, t;
+
+    EEPRWL_Main.initialize(1, HANDLE1);
+    for (uint16_t i = 0; i < records; i++) EEPRWL_Main.write(i, HANDLE1);
+
+    // 1. Binary search (library)
+    EEPRWL_ioReads = 0; t = micros();
+    EEPRWL_Main.findNewestData(HANDLE1);
+    t = micros() - t; fast = EEPRWL_ioReads;
+
+    Serial.print(F("records: ")); Serial.print(records);
+    Serial.print(F("\tnewest: ")); Serial.print(EEPRWL_Main.getCtrlData(currentLogicalCounter, HANDLE1));
+    Serial.print(F("\tbinary search e_r: ")); Serial.print(fast);
+    Serial.print(F(" (")); Serial.print(t); Serial.print(F(" us)"));
+
+    // 2. Full scan reference: every sector once
+    EEPRWL_ioReads = 0; t = micros();
+    for (uint16_t i = 1; i <= sectors; i++) EEPRWL_Main.loadPhysSector(i, HANDLE1);
+    t = micros() - t; linear = EEPRWL_ioReads;
+
+    Serial.print(F("\tfull scan e_r: ")); Serial.print(linear);
+    Serial.print(F(" (")); Serial.print(t); Serial.println(F(" us)"));
+}
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench1: head lookup                          ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    EEPRWL_Main.config(ADDR1, SIZE1, PAYLOAD_SIZE, COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    uint16_t sectors = EEPRWL_Main.getCtrlData(numberOfSectors, HANDLE1);
+    Serial.print(F("Sectors: ")); Serial.println(sectors);
+
+    // empty, partially filled, full, wrapped around
+    measure(1);
+    measure(sectors / 3);
+    measure(sectors);
+    measure(sectors + sectors / 2);
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
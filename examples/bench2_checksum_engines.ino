@@ -0,0 +1,96 @@
+// #############################################
+// ####### Bench2: sector checksum engines #####
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// Measures the CPU cycles per byte of all sector checksum
+// engines for the sector sizes used by the demos (payload +
+// logical counter, the bytes covered by the checksum).
+// The engine used by the library is selected with EEPRWL_CHECKSUM
+// in EEProm_Safe_Wear_Level_Macros.h.
+//
+// No EEPROM access takes place in this sketch.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+// ----------------------------------------------------
+// --- DEFINITIONS ---
+// ----------------------------------------------------
+
+#define ITERATIONS 500
+
+// Checksummed bytes per sector:
+// demo2 (2+1), demo7 (1+3), demo4 (4+1), demo3 (7+1), demo4 (9+1), demo5/6 (9+2), demo1 (12+1),
+// 32 byte struct (32+2)
+const uint8_t sizes[] = {3, 4, 5, 8, 10, 11, 13, 34};
+
+uint8_t buffer[34];
+volatile uint16_t sink;   // keeps the compiler from removing the loops
+
+// ----------------------------------------------------
+// --- HELPER ---
+// ----------------------------------------------------
+
+void printCycles(uint32_t us, uint8_t len) {
+    // cycles per byte with one decimal place
+    uint32_t c10 = (us * (F_CPU / 100000UL)) / ((uint32_t)ITERATIONS * len);
+    Serial.print(c10 / 10); Serial.print('.'); Serial.print(c10 % 10);
+    Serial.print('\t');
+}
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench2: checksum engines (cycles per byte)  ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("bytes\tCRC8\tNIBBLE\tTABLE\tCRC16\tFLETCH"));
+
+    for (uint8_t i = 0; i < sizeof(buffer); i++) buffer[i] = i * 37 + 11;
+
+    for (uint8_t s = 0; s < sizeof(sizes); s++) {
+        uint8_t len = sizes[s];
+        uint32_t t;
+        uint16_t i;
+
+        Serial.print(len); Serial.print('\t');
+
+        t = micros();
+        for (i = 0; i < ITERATIONS; i++) sink = eeprwlCrc8(buffer, len);
+        printCycles(micros() - t, len);
+
+        t = micros();
+        for (i = 0; i < ITERATIONS; i++) sink = eeprwlCrc8Nibble(buffer, len);
+        printCycles(micros() - t, len);
+
+        t = micros();
+        for (i = 0; i < ITERATIONS; i++) sink = eeprwlCrc8Table(buffer, len);
+        printCycles(micros() - t, len);
+
+        t = micros();
+        for (i = 0; i < ITERATIONS; i++) sink = eeprwlCrc16(buffer, len);
+        printCycles(micros() - t, len);
+
+        t = micros();
+        for (i = 0; i < ITERATIONS; i++) sink = eeprwlFletcher16(buffer, len);
+        printCycles(micros() - t, len);
+
+        Serial.println();
+    }
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
@@ -0,0 +1,108 @@
+// #############################################
+// ####### Bench3: page-aligned burst writes ###
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// Counts the EEPROM write cycles of an external page EEPROM
+// (24LC32: 32 byte pages, ~5 ms per write cycle) for the format
+// of a partition and for a series of records:
+//  - bytewise : every byte is its own write cycle
+//  - paged    : the backend reports its page size, the library
+//               packs the sectors into the pages and writes every
+//               sector / format block in one burst
+// The EEPROM is simulated in RAM (EEPRWL_RamStorage with page
+// size), so the sketch runs without external hardware.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define MEMORY_SIZE   512
+#define PAGE_SIZE     32
+#define WRITE_MS      5     // typical write cycle of a 24LCxx
+#define RECORDS       200
+#define HANDLE1       0
+
+//Offset Definitions for PartitionsData
+#define numberOfSectors 8
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+uint8_t memory[MEMORY_SIZE];
+
+// Page EEPROM without page support: one write cycle per byte
+class BytewiseStorage : public EEPRWL_RamStorage {
+    public:
+      BytewiseStorage(uint8_t* mem, uint16_t size) : EEPRWL_RamStorage(mem, size, 0) {}
+
+      void writeBlock(uint16_t addr, const uint8_t* buffer, uint16_t len) {
+          for (uint16_t i = 0; i < len; i++) write(addr + i, buffer[i]);
+      }
+};
+
+struct Record {
+    uint32_t time;
+    int16_t  temperature;
+    uint8_t  state;
+} record;
+
+// ----------------------------------------------------
+// --- HELPER ---
+// ----------------------------------------------------
+
+void runBench(const char* name, EEPRWL_RamStorage& storage) {
+    memset(memory, 0xFF, sizeof(memory));   // erased EEPROM
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data, storage);
+
+    EEPRWL.config(0, MEMORY_SIZE - 16, sizeof(record), 3, 255, HANDLE1);
+    uint32_t formatCycles = storage.writeCycles;
+
+    for (uint16_t i = 0; i < RECORDS; i++) {
+        record.time = i; record.temperature = 200 + (i & 15); record.state = i & 3;
+        EEPRWL.write(record, HANDLE1);
+    }
+    uint32_t writeCycles = storage.writeCycles - formatCycles;
+
+    Serial.print(name); Serial.print('\t');
+    Serial.print(EEPRWL.getCtrlData(numberOfSectors, HANDLE1)); Serial.print('\t');
+    Serial.print(formatCycles); Serial.print('\t');
+    Serial.print(formatCycles * WRITE_MS); Serial.print('\t');
+    Serial.print(writeCycles); Serial.print('\t');
+    Serial.println(writeCycles * WRITE_MS / RECORDS);
+}
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench3: page-aligned burst writes           ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("backend\tsectors\tformat\tms\twrites\tms/record"));
+
+    BytewiseStorage bytewise(memory, MEMORY_SIZE);
+    EEPRWL_RamStorage paged(memory, MEMORY_SIZE, PAGE_SIZE);
+
+    runBench("bytewise", bytewise);
+    runBench("paged", paged);
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
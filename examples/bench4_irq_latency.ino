@@ -0,0 +1,96 @@
+// #############################################
+// ####### Bench4: interrupt-off windows #######
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// Measures the longest interrupt-off window of each API call.
+// This is the worst-case additional latency of every interrupt
+// routine (serial RX, encoder, timekeeping) caused by the library.
+//
+// Compare both locking modes (EEProm_Safe_Wear_Level_Macros.h):
+//  EEPRWL_LOCK_FULL : interrupts off for the whole call
+//  EEPRWL_LOCK_SHORT: interrupts off only for the control block
+//
+// REQUIREMENT: Uncomment '#define EEPRWL_IRQ_STATS' in
+// EEProm_Safe_Wear_Level_Macros.h.
+//
+// WARNING: The partition is formatted and written to.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+#ifndef EEPRWL_IRQ_STATS
+  #error "Enable EEPRWL_IRQ_STATS in EEProm_Safe_Wear_Level_Macros.h"
+#endif
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 255
+#define HANDLE1  0
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+uint32_t value = 0;
+
+// ----------------------------------------------------
+// --- HELPER ---
+// ----------------------------------------------------
+
+void report(const char* name) {
+    Serial.print(name); Serial.print('\t');
+    Serial.println(EEPRWL_irqOffMax);
+    EEPRWL_irqOffMax = 0;
+}
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench4: interrupt-off windows [us]          ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.print(F("Locking mode: "));
+    Serial.println(EEPRWL_LOCK == EEPRWL_LOCK_SHORT ? F("EEPRWL_LOCK_SHORT") : F("EEPRWL_LOCK_FULL"));
+    Serial.println(F("call\t\tmax. irq-off"));
+
+    EEPRWL_irqOffMax = 0;
+    EEPRWL.config(0, 256, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    report("config()");
+
+    EEPRWL.initialize(1, HANDLE1);
+    report("initialize(1)");
+
+    for (uint8_t i = 0; i < 10; i++) EEPRWL.write(++value, HANDLE1);
+    report("write()\t");
+
+    EEPRWL.findNewestData(HANDLE1);
+    report("findNewest()");
+
+    EEPRWL.read(3, value, HANDLE1);
+    report("read(3)\t");
+
+    EEPRWL.getCtrlData(14, HANDLE1);
+    report("getCtrlData()");
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
@@ -0,0 +1,112 @@
+// #############################################
+// ####### Bench5: log dump ####################
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// Compares two ways to dump a complete log partition (e.g. for
+// an upload by a service tool):
+//  - findOldestData() followed by a read(next, ...) loop
+//  - forEachRecord(): streams the valid records to a visitor
+//    function (payload pointer + logical counter, no copy)
+// Output: time in us and the sum of the logical counters of the
+// visited records (both methods must deliver the same sum).
+//
+// WARNING: The partition is formatted and written to.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 255
+#define HANDLE1  0
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0
+#define numberOfSectors 8
+
+// read modes
+#define next   1
+#define oldest 3
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+struct Record {
+    uint32_t time;
+    int16_t  temperature;
+} record;
+
+uint32_t checkSum = 0;
+
+// ----------------------------------------------------
+// --- HELPER ---
+// ----------------------------------------------------
+
+// Visitor: payload points into the I/O buffer of the library
+// (a service tool would send it, e.g. Serial.write(payload, sizeof(Record)))
+bool addRecord(const uint8_t* payload, uint32_t counter, void* context) {
+    checkSum += counter;
+    return true;   // false: stop
+}
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench5: log dump                             ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    EEPRWL.config(0, 512, sizeof(record), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    EEPRWL.initialize(1, HANDLE1);
+
+    // Fill the ring more than once
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+    for (uint16_t i = 0; i < sectors + sectors / 2; i++) {
+        record.time = i; record.temperature = i & 63;
+        EEPRWL.write(record, HANDLE1);
+    }
+    Serial.print(F("Sectors: ")); Serial.println(sectors);
+    Serial.println(F("method\t\tus\tcounter sum"));
+
+    // 1. read() loop
+    uint32_t t = micros();
+    checkSum = 0;
+    if (EEPRWL.read(oldest, record, HANDLE1)) {
+        checkSum += EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1);
+        for (uint16_t i = 1; i < sectors; i++) {
+            if (EEPRWL.read(next, record, HANDLE1)) checkSum += EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1);
+        }
+    }
+    t = micros() - t;
+    Serial.print(F("read(next)\t")); Serial.print(t); Serial.print('\t'); Serial.println(checkSum);
+
+    // 2. forEachRecord(): from oldest (3), all records (0), to newer records (1)
+    t = micros();
+    checkSum = 0;
+    EEPRWL.forEachRecord(oldest, 0, next, addRecord, HANDLE1);
+    t = micros() - t;
+    Serial.print(F("forEachRecord\t")); Serial.print(t); Serial.print('\t'); Serial.println(checkSum);
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
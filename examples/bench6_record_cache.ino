@@ -0,0 +1,80 @@
+// #############################################
+// ####### Bench6: record cache ################
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// Three partitions share the I/O buffer of one instance. read(0)
+// alternating over the partitions reloads the sector from the
+// EEPROM and checks its checksum on every switch - unless the
+// newest records are held in the record cache.
+// Output: time per read(0) in us, same partition and alternating.
+//
+// Compare both builds (EEProm_Safe_Wear_Level_Macros.h):
+//  #define EEPRWL_RECORD_CACHE 0   (default, no RAM)
+//  #define EEPRWL_RECORD_CACHE 3   (3 * (8 + 6) bytes RAM)
+//
+// WARNING: The partitions are formatted and written to.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 255
+#define PART_CNT 3
+#define READS    300
+
+typedef struct {
+    uint8_t data[16 * PART_CNT];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+uint32_t value[PART_CNT];
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench6: record cache                        ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.print(F("EEPRWL_RECORD_CACHE: ")); Serial.println(EEPRWL_RECORD_CACHE);
+
+    for (uint8_t h = 0; h < PART_CNT; h++) {
+        EEPRWL.config(h * 128, 128, sizeof(uint32_t), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, h);
+        value[h] = 1000 + h;
+        EEPRWL.write(value[h], h);
+    }
+    Serial.println(F("read(0)\t\tus/read"));
+
+    // 1. Always the same partition: the I/O buffer holds the record
+    uint32_t t = micros();
+    for (uint16_t i = 0; i < READS; i++) EEPRWL.read(0, value[0], 0);
+    t = micros() - t;
+    Serial.print(F("same\t\t")); Serial.println((float)t / READS);
+
+    // 2. Alternating partitions
+    t = micros();
+    for (uint16_t i = 0; i < READS; i++) EEPRWL.read(0, value[i % PART_CNT], i % PART_CNT);
+    t = micros() - t;
+    Serial.print(F("alternating\t")); Serial.println((float)t / READS);
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
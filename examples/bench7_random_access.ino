@@ -0,0 +1,82 @@
+// #############################################
+// ####### Bench7: random access ###############
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// A trend display needs the record newest-k of a log:
+//  - read(2) k times: k sector reads, each with checksum
+//  - readRelative(-k): the sector follows from the counter,
+//    one sector read
+// Output: EEPROM block reads (readTransfers) and time in us for
+// several k. The EEPROM is simulated in RAM (EEPRWL_RamStorage),
+// so the reads can be counted.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define MEMORY_SIZE   1024
+#define HANDLE1       0
+
+// read modes
+#define previous 2
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+uint8_t memory[MEMORY_SIZE];
+EEPRWL_RamStorage storage(memory, MEMORY_SIZE);
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data, storage);
+
+uint32_t value;
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench7: random access                       ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    memset(memory, 0xFF, sizeof(memory));
+    EEPRWL.config(0, MEMORY_SIZE - 16, sizeof(value), 3, 255, HANDLE1);
+    uint16_t sectors = EEPRWL.getCtrlData(8, HANDLE1);
+    for (value = 1; value <= sectors * 2; value++) EEPRWL.write(value, HANDLE1);
+
+    Serial.println(F("k\tread(2)\tus\treadRelative\tus"));
+    for (uint16_t k = 1; k < sectors; k *= 4) {
+        // 1. k steps back from the newest record
+        EEPRWL.findNewestData(HANDLE1);
+        uint32_t reads = storage.readTransfers, t = micros();
+        for (uint16_t i = 0; i < k; i++) EEPRWL.read(previous, value, HANDLE1);
+        t = micros() - t;
+        Serial.print(k); Serial.print('\t');
+        Serial.print(storage.readTransfers - reads); Serial.print('\t'); Serial.print(t); Serial.print('\t');
+
+        // 2. direct access
+        EEPRWL.findNewestData(HANDLE1);
+        reads = storage.readTransfers; t = micros();
+        EEPRWL.readRelative(-(int32_t)k, value, HANDLE1);
+        t = micros() - t;
+        Serial.print(storage.readTransfers - reads); Serial.print("\t\t"); Serial.println(t);
+    }
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
@@ -0,0 +1,90 @@
+// #############################################
+// ####### Bench8: format cost #################
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// Measures initialize(1, ...) (forced format) of a filled
+// partition: time in ms and EEPROM bytes written.
+// A lazy format only starts a new format epoch (getCtrlData(13))
+// and writes the metadata; every (EEPRWL_LAZY_FORMAT + 1)th format
+// zero-fills the sectors (epoch 0).
+//
+// Compare both builds (EEProm_Safe_Wear_Level_Macros.h):
+//  #define EEPRWL_LAZY_FORMAT 7   (default)
+//  #define EEPRWL_LAZY_FORMAT 0   (every format zero-fills)
+//
+// REQUIREMENT: Uncomment '#define EEPRWL_IO_STATS' in
+// EEProm_Safe_Wear_Level_Macros.h, otherwise the write counter
+// does not exist.
+//
+// WARNING: The partition is formatted and written to many times.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+#ifndef EEPRWL_IO_STATS
+  #error "Enable EEPRWL_IO_STATS in EEProm_Safe_Wear_Level_Macros.h"
+#endif
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 255
+#define HANDLE1  0
+#define FORMATS  9
+
+//Offset Definitions for PartitionsData
+#define numberOfSectors 8
+#define formatEpoch     13
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+uint32_t value;
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench8: format cost                         ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.print(F("EEPRWL_LAZY_FORMAT: ")); Serial.println(EEPRWL_LAZY_FORMAT);
+
+    EEPRWL.config(0, 512, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+    Serial.println(F("format\tepoch\tms\tbytes written"));
+
+    for (uint8_t f = 1; f <= FORMATS; f++) {
+        // Fill the ring once
+        for (value = 1; value <= sectors; value++) EEPRWL.write(value, HANDLE1);
+
+        uint32_t writes = EEPRWL_ioWrites, t = millis();
+        EEPRWL.initialize(1, HANDLE1);
+        t = millis() - t;
+        Serial.print(f); Serial.print('\t');
+        Serial.print(EEPRWL.getCtrlData(formatEpoch, HANDLE1)); Serial.print('\t');
+        Serial.print(t); Serial.print('\t');
+        Serial.println(EEPRWL_ioWrites - writes);
+    }
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
@@ -0,0 +1,93 @@
+// #############################################
+// ####### Bench9: boot time ###################
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// Boot with 8 partitions: time of the config() calls in setup()
+// and the time until all partitions are restored by idle() calls
+// from loop(). Send any character: the layout of all partitions
+// changes (payload size), the next boot zero-fills them.
+//
+// Compare both builds (EEProm_Safe_Wear_Level_Macros.h):
+//  #define EEPRWL_LAZY_INIT 0   (default, config() restores at once)
+//  #define EEPRWL_LAZY_INIT 4   (deferred restore, 4 sectors per idle())
+//
+// WARNING: The partitions are formatted on a layout change.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 255
+#define PART_CNT  8
+#define PART_SIZE 120
+#define LAYOUT_ADDR (PART_CNT * PART_SIZE)
+
+typedef struct {
+    uint8_t data[16 * PART_CNT];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+uint8_t payload;
+bool restored = false;
+uint32_t bootTime;
+uint16_t idleCalls = 0;
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Bench9: boot time                          ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.print(F("EEPRWL_LAZY_INIT: ")); Serial.println(EEPRWL_LAZY_INIT);
+
+    // Payload size of this boot (byte behind the partitions)
+    payload = (EEPROM.read(LAYOUT_ADDR) == 4) ? 4 : 2;
+
+    bootTime = micros();
+    uint32_t t = micros();
+    for (uint8_t h = 0; h < PART_CNT; h++) {
+        EEPRWL.config(h * PART_SIZE, PART_SIZE, payload, COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, h);
+    }
+    t = micros() - t;
+    Serial.print(F("config() x ")); Serial.print(PART_CNT); Serial.print(F(" [us]: ")); Serial.println(t);
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+    if (!restored) {
+        EEPRWL.idle();
+        idleCalls++;
+
+        restored = true;
+        for (uint8_t h = 0; h < PART_CNT; h++) restored &= EEPRWL.isRestored(h);
+        if (restored) {
+            Serial.print(F("All restored after [us]: ")); Serial.print(micros() - bootTime);
+            Serial.print(F(", idle() calls: ")); Serial.println(idleCalls);
+        }
+    }
+
+    // Layout change for the next boot
+    if (Serial.available()) {
+        while (Serial.available()) Serial.read();
+        EEPROM.update(LAYOUT_ADDR, (payload == 4) ? 2 : 4);
+        Serial.println(F("Layout changed: reset the board"));
+    }
+}
+//END OF CODE
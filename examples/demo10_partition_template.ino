@@ -0,0 +1,108 @@
+// #############################################
+// ####### Demo10: compile-time partitions #####
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// EEPromPartition<Start, Size, Payload, CntLen> describes a fixed
+// partition layout. Sector count, sector addresses and the counter
+// limit are compile-time constants; a partition that is too small,
+// overlaps the WLM bucket area at the end of the EEPROM or overlaps
+// another partition (EEPRWL_disjoint) stops the compilation.
+// The partition object forwards the calls to the library instance
+// and needs no handle parameter.
+//
+// Try it: change SIZE2 to 600 and compile again.
+//
+// This demo builds on previous ones. Please understand that a
+// basic understanding from those other demos is a prerequisite.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define WRITE_CYCLES_PER_HOUR 60
+#define PART_CNT 2
+#define HANDLE1  0
+#define HANDLE2  1
+
+// --- ADDRESSES AND SIZES ---
+#define ADDR1 0
+#define SIZE1 128
+#define ADDR2 (ADDR1 + SIZE1)
+#define SIZE2 256
+
+typedef struct {
+    uint8_t data[16 * PART_CNT];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+struct Settings {
+    uint16_t setpoint;
+    uint8_t  mode;
+} settings;
+
+struct Record {
+    uint32_t time;
+    int16_t  temperature;
+} record;
+
+// Layouts: counter length 2 bytes for the settings, 3 bytes for the log
+typedef EEPromPartition<ADDR1, SIZE1, sizeof(Settings), 2> SettingsLayout;
+typedef EEPromPartition<ADDR2, SIZE2, sizeof(Record), 3> LogLayout;
+
+static_assert(EEPRWL_disjoint<SettingsLayout, LogLayout>(), "Partitions overlap");
+
+SettingsLayout settingsPart(EEPRWL, HANDLE1);
+LogLayout logPart(EEPRWL, HANDLE2);
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Demo10: compile-time partitions             ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    // Constants, no library call
+    Serial.print(F("Log sectors: ")); Serial.print(LogLayout::sectors);
+    Serial.print(F("\tsector size: ")); Serial.print(LogLayout::sectorSize);
+    Serial.print(F("\tmax. counter: ")); Serial.println(LogLayout::maxCounter);
+    Serial.print(F("Address of the last log sector: ")); Serial.println(LogLayout::sectorAddress(LogLayout::sectors - 1));
+
+    // config() returns 0 if the storage backend does not match the layout
+    if (!settingsPart.config(WRITE_CYCLES_PER_HOUR) || !logPart.config(WRITE_CYCLES_PER_HOUR)) {
+        Serial.println(F("config ERROR!"));
+    }
+
+    if (!settingsPart.read(0, settings)) {
+        settings.setpoint = 215; settings.mode = 1;
+        settingsPart.write(settings);
+    }
+    Serial.print(F("Setpoint: ")); Serial.println(settings.setpoint);
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+    record.time = millis();
+    record.temperature = 200 + (record.time & 15);
+    logPart.write(record);
+
+    Serial.print(F("Record ")); Serial.print(logPart.getCtrlData(0));
+    Serial.print(F(" in sector ")); Serial.println(LogLayout::sectorOf(logPart.getCtrlData(0)));
+    delay(60000);
+}
+//END OF CODE
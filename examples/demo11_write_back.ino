@@ -0,0 +1,113 @@
+// #############################################
+// ####### Demo11: write-back ##################
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// A setpoint is changed in bursts (e.g. with an encoder): every
+// change calls write(), but only the final value matters.
+// In write-back mode write() only updates a RAM slot; the sector
+// is written by flush() or by idle() after EEPRWL_WRITE_BACK_MS.
+// oneTickPassed() (timer or interrupt) never writes. A burst costs one sector and
+// one write credit instead of Write Shedding (status 8).
+// On a power-fail warning (e.g. comparator on the unregulated
+// supply, pin POWER_FAIL_PIN low) powerFail() writes the unsaved
+// values immediately, without write budget check.
+//
+// REQUIREMENT: '#define EEPRWL_WRITE_BACK 1' (or more) in
+// EEProm_Safe_Wear_Level_Macros.h.
+//
+// This demo builds on previous ones. Please understand that a
+// basic understanding from those other demos is a prerequisite.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+#if EEPRWL_WRITE_BACK < 1
+  #error "Set EEPRWL_WRITE_BACK in EEProm_Safe_Wear_Level_Macros.h"
+#endif
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 10
+#define HANDLE1  0
+#define POWER_FAIL_PIN 2
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0
+#define status 14
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+uint16_t setpoint = 200;
+uint32_t lastTick = 0;
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+    pinMode(POWER_FAIL_PIN, INPUT_PULLUP);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Demo11: write-back                          ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    EEPRWL.config(0, 128, sizeof(setpoint), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    EEPRWL.read(0, setpoint, HANDLE1);
+    Serial.print(F("Setpoint after reboot: ")); Serial.println(setpoint);
+
+    if (!EEPRWL.setWriteBack(true, HANDLE1)) Serial.println(F("setWriteBack ERROR (handle or payload size)"));
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+    // Power-fail warning: save at once
+    if (digitalRead(POWER_FAIL_PIN) == LOW && EEPRWL.isDirty(HANDLE1)) {
+        EEPRWL.powerFail();
+        Serial.println(F("Power fail: unsaved setpoint written"));
+    }
+
+    // Burst of changes, e.g. an encoder turned by 25 steps
+    if (Serial.available()) {
+        while (Serial.available()) Serial.read();
+        for (uint8_t i = 0; i < 25; i++) {
+            setpoint++;
+            EEPRWL.write(setpoint, HANDLE1);
+        }
+        Serial.print(F("Setpoint ")); Serial.print(setpoint);
+        Serial.print(F(" staged, status ")); Serial.print(EEPRWL.getCtrlData(status, HANDLE1));
+        Serial.print(F(", records ")); Serial.println(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1));
+    }
+
+    // Time management: every 8 s a tick (time base only)
+    if (millis() - lastTick >= 8000) {
+        lastTick = millis();
+        if (EEPRWL.isDirty(HANDLE1)) {
+            Serial.print(F("Unsaved for [ms]: ")); Serial.println(EEPRWL.dirtyAge(HANDLE1));
+        }
+        EEPRWL.oneTickPassed();
+    }
+
+    // Deferred work: idle() flushes the slot after EEPRWL_WRITE_BACK_MS
+    bool dirty = EEPRWL.isDirty(HANDLE1);
+    EEPRWL.idle();
+    if (dirty && !EEPRWL.isDirty(HANDLE1)) {
+        Serial.print(F("Flushed, records: ")); Serial.println(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1));
+    }
+}
+//END OF CODE
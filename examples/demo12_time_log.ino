@@ -0,0 +1,103 @@
+// #############################################
+// ####### Demo12: timestamped log #############
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// A temperature log with a timestamp in every record (config()
+// parameter timeBytes). The timestamps rise with the logical
+// counter, so a point in time is found with a binary search over
+// the ring instead of a scan:
+//  - findByTime(t): oldest record with timestamp >= t
+//  - forEachInTimeRange(t1, t2, visitor): all records in [t1, t2]
+// The clock is millis() in seconds (resolution 1000); a real
+// logger would use an RTC with setTimeSource(), as millis()
+// restarts at 0 after a reset.
+//
+// Send any character: the records of the last 30 seconds are
+// printed.
+//
+// This demo builds on previous ones. Please understand that a
+// basic understanding from those other demos is a prerequisite.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define TIME_BYTES            3
+#define WRITE_CYCLES_PER_HOUR 255
+#define HANDLE1  0
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+int16_t temperature;
+uint32_t lastLog = 0;
+
+// ----------------------------------------------------
+// --- HELPER ---
+// ----------------------------------------------------
+
+// Visitor: prints timestamp and value of one record
+bool printRecord(const uint8_t* payload, uint32_t counter, void* context) {
+    int16_t value;
+    memcpy(&value, payload, sizeof(value));
+    Serial.print(EEPRWL.recordTime(HANDLE1) / 1000); Serial.print(F(" s\t"));
+    Serial.println(value);
+    return true;
+}
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Demo12: timestamped log                     ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    EEPRWL.config(0, 512, sizeof(temperature), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1, TIME_BYTES);
+    // millis() is restarted: old records would have newer timestamps
+    EEPRWL.initialize(1, HANDLE1);
+    EEPRWL.setTimeSource(millis, 1000);
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+    // One record every 2 seconds
+    if (millis() - lastLog >= 2000) {
+        lastLog = millis();
+        temperature = 200 + (lastLog / 1000 & 15);
+        EEPRWL.write(temperature, HANDLE1);
+    }
+
+    if (Serial.available()) {
+        while (Serial.available()) Serial.read();
+        uint32_t now = millis();
+        uint32_t from = (now > 30000) ? now - 30000 : 0;
+
+        // Oldest record of the period (O(log n) sector reads)
+        if (EEPRWL.findByTime(from, HANDLE1)) {
+            Serial.print(F("First record at ")); Serial.print(EEPRWL.recordTime(HANDLE1) / 1000);
+            Serial.print(F(" s, counter ")); Serial.println(EEPRWL.getCtrlData(0, HANDLE1));
+        }
+        uint16_t n = EEPRWL.forEachInTimeRange(from, now, printRecord, HANDLE1);
+        Serial.print(n); Serial.println(F(" records"));
+    }
+}
+//END OF CODE
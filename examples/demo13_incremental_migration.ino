@@ -0,0 +1,99 @@
+// #############################################
+// ####### Demo13: incremental migration #######
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// A log partition (HANDLE1) is moved to a second partition
+// (HANDLE2) while the sketch keeps running: migrateBegin()
+// defines the job, idle() copies EEPRWL_MIGRATE_STEP records per
+// call, each with the write budget of the target. loop() is never
+// blocked for more than a few sector writes.
+// Reset the board during the migration: the job is continued
+// after the reboot, no record is copied twice or lost.
+//
+// REQUIREMENT: '#define EEPRWL_MIGRATE_JOB 1' in
+// EEProm_Safe_Wear_Level_Macros.h (persistent job).
+//
+// This demo builds on previous ones. Please understand that a
+// basic understanding from those other demos is a prerequisite.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+#if EEPRWL_MIGRATE_JOB < 1
+  #error "Set EEPRWL_MIGRATE_JOB 1 in EEProm_Safe_Wear_Level_Macros.h"
+#endif
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 255
+#define HANDLE1  0
+#define HANDLE2  1
+#define RECORDS  40
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0
+
+typedef struct {
+    uint8_t data[16 * 2];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+uint32_t value;
+uint32_t lastStep = 0;
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Demo13: incremental migration              ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    EEPRWL.config(0, 512, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    EEPRWL.config(512, 400, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE2);
+
+    if (EEPRWL.migratePending() > 0) {
+        // Interrupted by a reset: idle() continues the job
+        Serial.print(F("Migration resumed, records left: ")); Serial.println(EEPRWL.migratePending());
+        return;
+    }
+
+    // New job: fill the log, empty target
+    EEPRWL.initialize(1, HANDLE1);
+    EEPRWL.initialize(1, HANDLE2);
+    for (value = 1; value <= RECORDS; value++) EEPRWL.write(value, HANDLE1);
+
+    if (EEPRWL.migrateBegin(HANDLE1, HANDLE2, RECORDS)) Serial.println(F("Migration started"));
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+    // Slow loop for the demo: one slice every 500 ms
+    if (millis() - lastStep < 500 || EEPRWL.migratePending() == 0) return;
+    lastStep = millis();
+
+    EEPRWL.idle();
+    Serial.print(F("Target records: ")); Serial.print(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE2));
+    Serial.print(F(", left: ")); Serial.println(EEPRWL.migratePending());
+
+    if (EEPRWL.migratePending() == 0) {
+        EEPRWL.readRelative(0, value, HANDLE2);
+        Serial.print(F("Migration complete, newest value: ")); Serial.println(value);
+    }
+}
+//END OF CODE
@@ -0,0 +1,114 @@
+// #############################################
+// ####### Demo14: token bucket ################
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// Two partitions with their own write budget:
+//  - HANDLE1: a settings partition, 0.25 writes per hour
+//    (rate16 = 4), burst depth 3 writes
+//  - HANDLE2: a log partition, 500 writes per hour
+//    (rate16 = 8000), burst depth 1000 writes
+// The sketch tries to write both partitions every second and
+// prints the accepted writes, the remaining tokens and the status.
+// oneTickPassed() is called every 225 s of simulated time (one
+// clock step of the buckets) to show the refill.
+//
+// REQUIREMENT: '#define EEPRWL_TOKEN_BUCKETS 2' (or more) in
+// EEProm_Safe_Wear_Level_Macros.h.
+//
+// This demo builds on previous ones. Please understand that a
+// basic understanding from those other demos is a prerequisite.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+#if EEPRWL_TOKEN_BUCKETS < 2
+  #error "Set EEPRWL_TOKEN_BUCKETS 2 in EEProm_Safe_Wear_Level_Macros.h"
+#endif
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 1
+#define HANDLE1  0
+#define HANDLE2  1
+#define TICK_SECONDS 225
+
+//Offset Definitions for PartitionsData
+#define status 14
+
+typedef struct {
+    uint8_t data[16 * 2];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+// One tick = one clock step of the token buckets
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data, TICK_SECONDS);
+
+uint16_t setting = 0;
+uint32_t value = 0;
+uint8_t  steps = 0;
+
+// ----------------------------------------------------
+// --- HELPER ---
+// ----------------------------------------------------
+
+void printBucket(uint8_t handle, bool written) {
+    Serial.print(written ? F("ok  ") : F("--  "));
+    Serial.print(F("tokens ")); Serial.print(EEPRWL.getWriteTokens(handle));
+    Serial.print(F(", status ")); Serial.print(EEPRWL.getCtrlData(status, handle));
+    Serial.print(F("\t"));
+}
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Demo14: token bucket                        ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    EEPRWL.config(0, 256, sizeof(setting), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    EEPRWL.config(256, 512, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE2);
+
+    // Rates in 1/16 write per hour, depth in writes
+    EEPRWL.setWriteRate(4, 3, HANDLE1);
+    EEPRWL.setWriteRate(8000, 1000, HANDLE2);
+    Serial.println(F("step\tHANDLE1 (0.25/h)\t\t\tHANDLE2 (500/h)"));
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+    if (steps >= 100) return;
+    delay(1000);
+
+    // Every loop() is one simulated clock step (225 s)
+    EEPRWL.oneTickPassed();
+    steps++;
+
+    Serial.print(steps); Serial.print('\t');
+    setting++;
+    printBucket(HANDLE1, EEPRWL.write(setting, HANDLE1));
+
+    // The log writes a burst of 40 records per step (640 per hour)
+    uint8_t accepted = 0;
+    for (uint8_t i = 0; i < 40; i++) {
+        value++;
+        if (EEPRWL.write(value, HANDLE2)) accepted++;
+    }
+    Serial.print(accepted); Serial.print(F("/40 "));
+    printBucket(HANDLE2, accepted > 0);
+    Serial.println();
+}
+//END OF CODE
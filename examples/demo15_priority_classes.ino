@@ -0,0 +1,110 @@
+// #############################################
+// ####### Demo15: priority classes ############
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// Three partitions with different priority:
+//  - HANDLE_UI    (0): display settings, EEPRWL_PRIO_LOW
+//  - HANDLE_LOG   (8): measured values, EEPRWL_PRIO_NORMAL
+//    (handles 0 and 8 share the write credit bucket 0)
+//  - HANDLE_ALARM (1): alarm log, EEPRWL_PRIO_CRITICAL
+// A faulty loop writes all partitions as fast as possible. The
+// UI writes are shed first, the log runs bucket 0 empty. The
+// alarm log keeps writing from the reserve pool (status 18) when
+// its own budget is used up.
+// Output: shed and committed writes per class.
+//
+// REQUIREMENT: '#define EEPRWL_PRIORITY_POOL 20' (or more) in
+// EEProm_Safe_Wear_Level_Macros.h.
+//
+// WARNING: The partitions are written to many times.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+#if EEPRWL_PRIORITY_POOL < 1
+  #error "Set EEPRWL_PRIORITY_POOL in EEProm_Safe_Wear_Level_Macros.h"
+#endif
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 1
+#define HANDLE_UI     0
+#define HANDLE_ALARM  1
+#define HANDLE_LOG    8
+
+//Offset Definitions for PartitionsData
+#define status 14
+
+typedef struct {
+    uint8_t data[16 * 9];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+uint32_t value = 0;
+uint16_t rounds = 0;
+
+// ----------------------------------------------------
+// --- HELPER ---
+// ----------------------------------------------------
+
+void printClass(uint8_t priority) {
+    Serial.print(F("\tshed ")); Serial.print(EEPRWL.shedWrites(priority));
+    Serial.print(F("\tcommitted ")); Serial.println(EEPRWL.committedWrites(priority));
+}
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Demo15: priority classes                    ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    EEPRWL.config(0, 256, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE_UI);
+    EEPRWL.config(256, 256, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE_ALARM);
+    EEPRWL.config(512, 256, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE_LOG);
+
+    EEPRWL.setPriority(EEPRWL_PRIO_LOW, HANDLE_UI);
+    EEPRWL.setPriority(EEPRWL_PRIO_CRITICAL, HANDLE_ALARM);
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+    if (rounds >= 200) return;
+    rounds++;
+
+    // Faulty loop: every partition is written in every round
+    value++;
+    EEPRWL.write(value, HANDLE_UI);
+    EEPRWL.write(value, HANDLE_LOG);
+    bool alarm = EEPRWL.write(value, HANDLE_ALARM);
+
+    if (rounds % 20 == 0 || EEPRWL.getCtrlData(status, HANDLE_ALARM) == 18) {
+        Serial.print(F("Round ")); Serial.print(rounds);
+        Serial.print(F(": UI balance ")); Serial.print(EEPRWL.getWrtAccBalance(HANDLE_UI));
+        Serial.print(F(", alarm ")); Serial.print(alarm ? F("written") : F("shed"));
+        Serial.print(F(", alarm status ")); Serial.println(EEPRWL.getCtrlData(status, HANDLE_ALARM));
+    }
+
+    if (rounds == 200) {
+        Serial.print(F("LOW")); printClass(EEPRWL_PRIO_LOW);
+        Serial.print(F("NORMAL")); printClass(EEPRWL_PRIO_NORMAL);
+        Serial.print(F("CRITICAL")); printClass(EEPRWL_PRIO_CRITICAL);
+    }
+}
+//END OF CODE
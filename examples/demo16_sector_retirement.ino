@@ -0,0 +1,136 @@
+// #############################################
+// ####### Demo16: sector retirement ###########
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// A log partition on a simulated EEPROM (EEPRWL_RamStorage) with
+// worn-out cells: a worn cell keeps its old value, the sector
+// that contains it fails the verify of every write. One more cell
+// wears out every WEAR_EVERY records.
+// The failing sectors are retired to the spare sectors (status
+// 19), the writes succeed and the log keeps its size and order.
+// The third worn cell finds no spare left: that write fails.
+// Output per record with a retirement or a failure: the value,
+// the write result, the status and retiredSectors(). At the end
+// the whole log is read back, newest record first.
+//
+// REQUIREMENT: '#define EEPRWL_SPARE_SECTORS 2' in
+// EEProm_Safe_Wear_Level_Macros.h.
+//
+// This demo builds on previous ones. Please understand that a
+// basic understanding from those other demos is a prerequisite.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+#if EEPRWL_SPARE_SECTORS != 2
+  #error "Set EEPRWL_SPARE_SECTORS 2 in EEProm_Safe_Wear_Level_Macros.h"
+#endif
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define MEMORY_SIZE   512
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 255
+#define HANDLE1       0
+#define RECORDS       200
+#define WEAR_EVERY    50
+
+//Offset Definitions for PartitionsData
+#define numberOfSectors 8
+#define status 14
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+uint8_t memory[MEMORY_SIZE];
+
+// EEPROM with worn cells: a write to a worn cell has no effect
+class WornStorage : public EEPRWL_RamStorage {
+    public:
+      WornStorage(uint8_t* mem, uint16_t size) : EEPRWL_RamStorage(mem, size, 0), worn(0) {}
+
+      void write(uint16_t addr, uint8_t value) {
+          if (!isWorn(addr)) EEPRWL_RamStorage::write(addr, value);
+      }
+      void writeBlock(uint16_t addr, const uint8_t* buffer, uint16_t len) {
+          for (uint16_t i = 0; i < len; i++) write(addr + i, buffer[i]);
+      }
+      bool isWorn(uint16_t addr) {
+          for (uint8_t i = 0; i < worn; i++) if (cells[i] == addr) return true;
+          return false;
+      }
+
+      uint16_t cells[3];
+      uint8_t  worn;
+};
+
+WornStorage storage(memory, MEMORY_SIZE);
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data, storage);
+
+// Cells inside the ring of the partition (first payload byte of sectors 5, 16 and 29)
+const uint16_t wornCells[3] = {60, 148, 252};
+
+uint32_t value = 0;
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Demo16: sector retirement                   ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    memset(memory, 0xFF, sizeof(memory));   // erased EEPROM
+    EEPRWL.config(0, 400, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    Serial.print(F("Ring sectors: ")); Serial.print(EEPRWL.getCtrlData(numberOfSectors, HANDLE1));
+    Serial.print(F(", spare sectors: ")); Serial.println(EEPRWL_SPARE_SECTORS);
+    Serial.println(F("value\twritten\tstatus\tretired"));
+
+    for (uint16_t i = 1; i <= RECORDS; i++) {
+        // The next cell wears out
+        if (i % WEAR_EVERY == 0 && storage.worn < 3) {
+            storage.cells[storage.worn] = wornCells[storage.worn];
+            storage.worn++;
+        }
+
+        value = i;
+        uint8_t retired = EEPRWL.retiredSectors(HANDLE1);
+        bool written = EEPRWL.write(value, HANDLE1);
+
+        if (!written || EEPRWL.retiredSectors(HANDLE1) != retired) {
+            Serial.print(value); Serial.print('\t');
+            Serial.print(written); Serial.print('\t');
+            Serial.print(EEPRWL.getCtrlData(status, HANDLE1)); Serial.print('\t');
+            Serial.println(EEPRWL.retiredSectors(HANDLE1));
+        }
+    }
+
+    // The log, newest record first (a failed write leaves a gap)
+    Serial.println(F("Log:"));
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+    for (uint16_t k = 0; k < sectors; k++) {
+        if (EEPRWL.readRelative(-(int32_t)k, value, HANDLE1)) Serial.print(value);
+        else Serial.print('-');
+        Serial.print((k % 10 == 9) ? '\n' : ' ');
+    }
+    Serial.println();
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+}
+//END OF CODE
@@ -0,0 +1,100 @@
+// #############################################
+// ####### Demo8: external I2C EEPROM ##########
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// The same wear-leveling, CRC and WLM engine on an external
+// 24LC32 (4 KB, 32 byte pages) at I2C address 0x50, next to a
+// partition in the internal EEPROM. Every library instance
+// uses its own storage backend.
+// For FRAM (MB85RC...) use EEPRWL_I2CFRAM instead.
+//
+// REQUIREMENT: '#define EEPRWL_LOCK EEPRWL_LOCK_SHORT' in
+// EEProm_Safe_Wear_Level_Macros.h. Wire needs interrupts, which
+// are disabled during the whole API call in the default mode
+// EEPRWL_LOCK_FULL (the sketch does not compile with it). Do not
+// call the library from interrupt routines in this mode.
+//
+// This demo builds on previous ones. Please understand that a
+// basic understanding from those other demos is a prerequisite.
+//
+
+#include <Wire.h>
+#include <EEProm_Safe_Wear_Level.h>
+#include <EEProm_Safe_Wear_Level_I2C.h>
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 20
+#define HANDLE1  0
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0 // Counter for the total number of sectors written
+#define numberOfSectors 8       // Total number of available sectors in the partition
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t InternalData;
+AlignedArray_t ExternalData;
+
+// Storage backend: 24LC32 at 0x50, 4096 bytes, 32 byte pages
+EEPRWL_I2CEEPROM extEEPROM(0x50, 4096, 32);
+
+// One instance per memory
+EEProm_Safe_Wear_Level EEPRWL_Int(InternalData.data);
+EEProm_Safe_Wear_Level EEPRWL_Ext(ExternalData.data, extEEPROM);
+
+unsigned long value = 0;
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    Wire.begin();
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Demo8: external I2C EEPROM                   ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    int s1 = EEPRWL_Int.config(0, 256, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    int s2 = EEPRWL_Ext.config(0, 4000, sizeof(value), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+
+    if (!s1) Serial.println(F("internal partition config ERROR!"));
+    if (!s2) Serial.println(F("external partition config ERROR!"));
+
+    Serial.print(F("Sectors internal: ")); Serial.println(EEPRWL_Int.getCtrlData(numberOfSectors, HANDLE1));
+    Serial.print(F("Sectors external: ")); Serial.println(EEPRWL_Ext.getCtrlData(numberOfSectors, HANDLE1));
+
+    if (EEPRWL_Ext.read(0, value, HANDLE1)) {
+        Serial.print(F("Last value (external): ")); Serial.println(value);
+    }
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+    value = millis();
+
+    bool s1 = EEPRWL_Int.write(value, HANDLE1);
+    bool s2 = EEPRWL_Ext.write(value, HANDLE1);
+
+    Serial.print(F("Writing: ")); Serial.print(value);
+    Serial.print(F("\tinternal: ")); Serial.print(s1 ? F("OK") : F("failed"));
+    Serial.print(F("\texternal: ")); Serial.print(s2 ? F("OK") : F("failed"));
+    Serial.print(F("\tlogical counter ext.: "));
+    Serial.println(EEPRWL_Ext.getCtrlData(currentLogicalCounter, HANDLE1));
+
+    delay(60000);
+}
+//END OF CODE
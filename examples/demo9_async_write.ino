@@ -0,0 +1,101 @@
+// #############################################
+// ####### Demo9: asynchronous write ###########
+// #############################################
+// EEProm_Safe_Wear_Level Library v25.10.x
+// #############################################
+//
+// write() waits for every EEPROM write cycle (~3.4 ms per byte
+// on AVR). writeAsync() only stages the record and returns at
+// once. asyncStep() is called in every pass of loop(): it writes
+// one byte whenever the EEPROM is ready and never waits.
+// asyncState() reports the result of the verify.
+//
+// With #define EEPRWL_ASYNC_ISR (EEProm_Safe_Wear_Level_Macros.h)
+// the EEPROM-ready interrupt calls asyncStep() on AVR; the sketch
+// then only queries asyncState().
+//
+// This demo builds on previous ones. Please understand that a
+// basic understanding from those other demos is a prerequisite.
+//
+
+#include <EEProm_Safe_Wear_Level.h>
+
+// ----------------------------------------------------
+// --- DEFINITIONS AND INSTANCES ---
+// ----------------------------------------------------
+
+#define COUNTER_LENGTH_BYTES  3
+#define WRITE_CYCLES_PER_HOUR 60
+#define HANDLE1  0
+
+typedef struct {
+    uint8_t data[16];
+} __attribute__((aligned(8))) AlignedArray_t;
+AlignedArray_t PartitionsData;
+
+EEProm_Safe_Wear_Level EEPRWL(PartitionsData.data);
+
+struct Record {
+    uint32_t time;
+    uint16_t loops;
+} record;
+
+uint32_t loopsWhileWriting = 0;
+uint32_t startTime = 0;
+
+// ----------------------------------------------------
+// --- 2. SETUP ---
+// ----------------------------------------------------
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println(F("\n\n\n"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+    Serial.println(F("--- EEProm_Safe_Wear_Level Demo9: asynchronous write                   ---"));
+    Serial.println(F("---------------------------------------------------------------------------"));
+
+    if (!EEPRWL.config(0, 256, sizeof(record), COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1)) {
+        Serial.println(F("config ERROR!"));
+    }
+
+    // Synchronous write for comparison
+    startTime = micros();
+    EEPRWL.write(record, HANDLE1);
+    Serial.print(F("write() blocked for [us]: ")); Serial.println(micros() - startTime);
+}
+
+// ----------------------------------------------------
+// --- 3. LOOP ---
+// ----------------------------------------------------
+
+void loop() {
+    // Advance the pending write (one byte, only if the EEPROM is ready)
+    uint8_t state = EEPRWL.asyncStep();
+
+    if (state == EEPRWL_ASYNC_BUSY) {
+        loopsWhileWriting++;
+        return;
+    }
+
+    if (loopsWhileWriting > 0) {
+        Serial.print(F("writeAsync() finished after [us]: ")); Serial.print(micros() - startTime);
+        Serial.print(F("\tloop() passes meanwhile: ")); Serial.print(loopsWhileWriting);
+        Serial.print(F("\tresult: "));
+        Serial.println(state == EEPRWL_ASYNC_DONE ? F("verified") : F("verify failed"));
+        loopsWhileWriting = 0;
+        delay(5000);
+    }
+
+    // Stage the next record; the call returns at once
+    record.time = millis();
+    record.loops++;
+    startTime = micros();
+    if (!EEPRWL.writeAsync(record, HANDLE1)) {
+        Serial.print(F("writeAsync() rejected, status: "));
+        Serial.println(EEPRWL.getCtrlData(14, HANDLE1));
+        delay(5000);
+    }
+}
+//END OF CODE
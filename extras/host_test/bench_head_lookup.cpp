@@ -0,0 +1,60 @@
+// #############################################
+// ####### Host bench: head lookup #############
+// #############################################
+//
+// EEPROM bytes read (e_r / e_rb, EEPRWL_IO_STATS) by the head lookup
+// of config(), findNewestData() and read modes 3/4: the binary search
+// findMarginalSector() against the linear reference scan
+// scanMarginalSector(), on the same partition (empty, partially
+// filled, full, wrapped around).
+// Host counterpart of examples/bench1_head_lookup.ino.
+//
+// Build: make bench (-DEEPRWL_IO_STATS)
+//
+
+#include "host_test.h"
+
+#ifndef EEPRWL_IO_STATS
+  #error "Build with -DEEPRWL_IO_STATS"
+#endif
+
+#define HANDLE1 0
+#define MEMORY_SIZE 4096
+#define PAYLOAD_SIZE 2
+#define COUNTER_LENGTH_BYTES 2
+#define WRITE_CYCLES_PER_HOUR 255
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0
+#define numberOfSectors 8
+
+static uint8_t PartitionsData[16];
+
+int main() {
+    HostEEPROM<MEMORY_SIZE> eeprom;
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+    EEPRWL.config(0, MEMORY_SIZE - 16, PAYLOAD_SIZE, COUNTER_LENGTH_BYTES, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+
+    printf("sectors: %u, sector size: %u bytes\n", sectors, EEPRWL_HostProbe::sectorSize(EEPRWL, HANDLE1));
+    printf("records\tbinary search\tlinear scan\tfactor\n");
+
+    const uint16_t fill[] = {1, (uint16_t)(sectors / 3), sectors, (uint16_t)(sectors + sectors / 2)};
+    for (uint8_t f = 0; f < sizeof(fill) / sizeof(fill[0]); f++) {
+        EEPRWL.initialize(1, HANDLE1);
+        for (uint16_t i = 1; i <= fill[f]; i++) EEPRWL.write(i, HANDLE1);
+
+        uint32_t cBin, cLin;
+        uint16_t nBin, nLin;
+        uint32_t binary = EEPRWL_HostProbe::headLookup(EEPRWL, HANDLE1, false, cBin, nBin);
+        uint32_t linear = EEPRWL_HostProbe::headLookup(EEPRWL, HANDLE1, true, cLin, nLin);
+
+        // Both strategies must find the same head
+        CHECK(cBin == cLin && nBin == nLin);
+        CHECK(cBin == EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1));
+
+        printf("%u\t%lu\t\t%lu\t\t%lu\n", fill[f], (unsigned long)binary, (unsigned long)linear,
+               (unsigned long)(linear / (binary > 0 ? binary : 1)));
+    }
+    return TEST_RESULT("bench_head_lookup");
+}
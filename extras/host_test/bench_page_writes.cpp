@@ -0,0 +1,85 @@
+// #############################################
+// ####### Host bench: page writes #############
+// #############################################
+//
+// EEPROM write cycles and read transfers (EEPRWL_RamStorage counters)
+// of the format of a partition and of a series of records on a page
+// EEPROM (24LC32: 32 byte pages, ~5 ms per write cycle):
+//  - bytewise : every byte is its own write cycle
+//  - paged    : the backend reports its page size, the library packs
+//               the sectors into the pages and writes every sector /
+//               format block in one burst
+// Host counterpart of examples/bench3_page_writes.ino.
+//
+// Build: make bench
+//
+
+#include "host_test.h"
+
+#define MEMORY_SIZE   512
+#define PAGE_SIZE     32
+#define WRITE_MS      5     // typical write cycle of a 24LCxx
+#define RECORDS       200
+#define HANDLE1       0
+
+//Offset Definitions for PartitionsData
+#define numberOfSectors 8
+
+static uint8_t PartitionsData[16];
+static uint8_t memory[MEMORY_SIZE];
+
+// Page EEPROM without page support: one write cycle per byte
+class BytewiseStorage : public EEPRWL_RamStorage {
+    public:
+      BytewiseStorage(uint8_t* mem, uint16_t size) : EEPRWL_RamStorage(mem, size, 0) {}
+
+      void writeBlock(uint16_t addr, const uint8_t* buffer, uint16_t len) {
+          for (uint16_t i = 0; i < len; i++) write(addr + i, buffer[i]);
+      }
+};
+
+struct Record {
+    uint32_t time;
+    int16_t  temperature;
+    uint8_t  state;
+};
+
+// Write cycles of the records (without the format)
+static uint32_t runBench(const char* name, EEPRWL_RamStorage& storage) {
+    memset(memory, 0xFF, sizeof(memory));   // erased EEPROM
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, storage);
+    Record record = {0, 0, 0}, back;
+
+    EEPRWL.config(0, MEMORY_SIZE - 16, sizeof(record), 3, 255, HANDLE1);
+    uint32_t formatCycles = storage.writeCycles;
+    uint32_t formatReads = storage.readTransfers;
+
+    for (uint16_t i = 0; i < RECORDS; i++) {
+        record.time = i; record.temperature = 200 + (i & 15); record.state = i & 3;
+        CHECK(EEPRWL.write(record, HANDLE1));
+    }
+    uint32_t writeCycles = storage.writeCycles - formatCycles;
+    uint32_t readTransfers = storage.readTransfers - formatReads;
+
+    // Both backends store the same records
+    CHECK(EEPRWL.read(0, back, HANDLE1) && memcmp(&back, &record, sizeof(record)) == 0);
+
+    printf("%s\t%u\t%lu\t%lu\t%lu\t%lu\t%lu\t%lu\n", name, EEPRWL.getCtrlData(numberOfSectors, HANDLE1),
+           (unsigned long)formatCycles, (unsigned long)(formatCycles * WRITE_MS), (unsigned long)formatReads,
+           (unsigned long)writeCycles, (unsigned long)(writeCycles * WRITE_MS / RECORDS), (unsigned long)readTransfers);
+    return writeCycles;
+}
+
+int main() {
+    BytewiseStorage bytewise(memory, MEMORY_SIZE);
+    EEPRWL_RamStorage paged(memory, MEMORY_SIZE, PAGE_SIZE);
+
+    printf("records: %u, page size: %u bytes\n", RECORDS, PAGE_SIZE);
+    printf("backend\tsectors\tformat\tms\treads\twrites\tms/rec\treads\n");
+    uint32_t cyclesBytewise = runBench("bytewise", bytewise);
+    uint32_t cyclesPaged = runBench("paged", paged);
+
+    // One burst per sector instead of one cycle per byte
+    CHECK(cyclesPaged * sizeof(Record) <= cyclesBytewise);
+    return TEST_RESULT("bench_page_writes");
+}
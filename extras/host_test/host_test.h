@@ -0,0 +1,91 @@
+#ifndef EEPRWL_HOST_TEST_H
+#define EEPRWL_HOST_TEST_H
+
+// -----------------------------------------------------------
+// HOST TESTS
+// -----------------------------------------------------------
+// Check macros of the host test programs (no test framework).
+// A failed CHECK prints file, line and condition and counts as
+// a failure; TEST_RESULT() prints the summary and is the exit
+// code of main() (0 = all checks passed).
+
+#include <EEProm_Safe_Wear_Level.h>
+#include <stdio.h>
+
+static int testChecks = 0;
+static int testFailures = 0;
+
+#define CHECK(cond) do { \
+        testChecks++; \
+        if (!(cond)) { testFailures++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } \
+    } while (0)
+
+#define TEST_RESULT(name) \
+    (printf("%s: %d checks, %d failed\n", name, testChecks, testFailures), testFailures ? 1 : 0)
+
+// Simulated EEPROM: erased (0xFF) RAM array
+template <uint16_t Size>
+struct HostEEPROM {
+    uint8_t mem[Size];
+    EEPRWL_RamStorage storage;
+
+    HostEEPROM(uint16_t pageSize = 0) : storage(mem, Size, pageSize) { erase(); }
+    void erase() { memset(mem, 0xFF, Size); }
+};
+
+// EEPROM with a stuck cell: writes to stuckAddr are lost (0 = none). With stuckWrites
+// only that many writes are lost, then the cell works again (0xFFFF = always stuck).
+class StuckStorage : public EEPRWL_RamStorage {
+    public:
+      StuckStorage(uint8_t* mem, uint16_t size, uint16_t pageSize = 0)
+          : EEPRWL_RamStorage(mem, size, pageSize), stuckAddr(0), stuckWrites(0xFFFF) {}
+
+      void write(uint16_t addr, uint8_t value) {
+          if (stuckAddr == 0 || addr != stuckAddr || stuckWrites == 0) EEPRWL_RamStorage::write(addr, value);
+          else if (stuckWrites != 0xFFFF) stuckWrites--;
+      }
+      void writeBlock(uint16_t addr, const uint8_t* buffer, uint16_t len) {
+          for (uint16_t i = 0; i < len; i++) write(addr + i, buffer[i]);
+      }
+
+      uint16_t stuckAddr;
+      uint16_t stuckWrites;
+};
+
+// Access to the internals of the library class (friend)
+struct EEPRWL_HostProbe {
+    // EEPROM address of a ring sector, from the geometry of the engine
+    // (paged backends, spare sectors, ECC and checksum length included)
+    static uint16_t sectorAddr(EEProm_Safe_Wear_Level& w, uint8_t handle, uint16_t sector) {
+        uint16_t addr = 0;
+        if (w._start(handle)) { addr = w.sectorAddr(sector); w._end(); }
+        return addr;
+    }
+
+    // Size of a sector in bytes: payload, counter, [timestamp], [ECC], checksum
+    static uint16_t sectorSize(EEProm_Safe_Wear_Level& w, uint8_t handle) {
+        uint16_t size = 0;
+        if (w._start(handle)) { size = w._secSize; w._end(); }
+        return size;
+    }
+
+    // Bytes read by one head lookup (EEPRWL_IO_STATS): binary search or linear
+    // reference scan; counter and position of the found head
+    static uint32_t headLookup(EEProm_Safe_Wear_Level& w, uint8_t handle, bool linear, uint32_t& counter, uint16_t& next) {
+        uint32_t reads = 0;
+        if (!w._start(handle)) return 0;
+#ifdef EEPRWL_IO_STATS
+        EEPRWL_ioReads = 0;
+#endif
+        if (linear) w.scanMarginalSector(0);
+        else w.findMarginalSector(handle, 0);
+#ifdef EEPRWL_IO_STATS
+        reads = EEPRWL_ioReads;
+#endif
+        counter = w._controlCache->curLgcCnt; next = w._controlCache->nextPhSec;
+        w._end();
+        return reads;
+    }
+};
+
+#endif // EEPRWL_HOST_TEST_H
@@ -0,0 +1,108 @@
+// #############################################
+// ####### Host test: asynchronous write #######
+// #############################################
+//
+// writeAsync() / asyncStep() on EEPRWL_RamStorage with busyPolls
+// (the EEPROM reports busy after every write cycle):
+//  1. one pending job: a second writeAsync() is rejected (status 13)
+//  2. EEPRWL_ASYNC_DONE after the verify, the record survives a restart
+//  3. EEPRWL_ASYNC_FAILED on a stuck byte, the sector counts as corrupt
+//     (as with write()), the previous records stay readable
+//
+
+#include "host_test.h"
+
+#define HANDLE1 0
+#define PARTITION_SIZE 300
+#define WRITE_CYCLES_PER_HOUR 255
+#define BUSY_POLLS 4
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0
+#define numberOfSectors 8
+#define status 14
+
+static uint8_t PartitionsData[16];
+static uint8_t memory[512];
+
+// Runs the pending job to its end; returns the asyncStep() calls
+static uint32_t runJob(EEProm_Safe_Wear_Level& w, uint8_t& result) {
+    uint32_t steps = 0;
+    while ((result = w.asyncStep()) == EEPRWL_ASYNC_BUSY) steps++;
+    return steps;
+}
+
+static void testAsync() {
+    memset(memory, 0xFF, sizeof(memory));   // erased EEPROM
+    StuckStorage storage(memory, sizeof(memory));
+    storage.busyPolls = BUSY_POLLS;
+    uint32_t value, back;
+    uint8_t result;
+
+    {
+        EEProm_Safe_Wear_Level EEPRWL(PartitionsData, storage);
+        CHECK(EEPRWL.config(0, PARTITION_SIZE, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1) > 0);
+        CHECK(EEPRWL.asyncState() == EEPRWL_ASYNC_IDLE);
+        CHECK(EEPRWL.write((uint32_t)100, HANDLE1));
+
+        for (value = 101; value <= 110; value++) {
+            uint32_t cycles = storage.writeCycles;
+            CHECK(EEPRWL.writeAsync(value, HANDLE1));
+            CHECK(EEPRWL.asyncState() == EEPRWL_ASYNC_BUSY);
+            // writeAsync() only stages the record
+            CHECK(storage.writeCycles == cycles);
+
+            // 1. One pending job
+            CHECK(!EEPRWL.writeAsync(value + 1000, HANDLE1));
+            CHECK(EEPRWL.getCtrlData(status, HANDLE1) % 256 == 13);
+
+            // 2. Written byte by byte, every write cycle is polled busy
+            uint32_t steps = runJob(EEPRWL, result);
+            CHECK(result == EEPRWL_ASYNC_DONE);
+            CHECK(EEPRWL.asyncState() == EEPRWL_ASYNC_DONE);
+            CHECK(steps > (storage.writeCycles - cycles) * BUSY_POLLS);
+            CHECK(EEPRWL.read(0, back, HANDLE1) && back == value);
+            CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == value - 99);
+        }
+    }
+
+    // Re-construction: the asynchronous records are found
+    value--;
+    {
+        EEProm_Safe_Wear_Level restarted(PartitionsData, storage);
+        restarted.config(0, PARTITION_SIZE, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+        CHECK(restarted.read(0, back, HANDLE1) && back == value);
+        CHECK(restarted.readRelative(-9, back, HANDLE1) && back == value - 9);
+
+        // 3. Stuck byte: first payload byte of the next sector (no wrap yet)
+        uint16_t sector = restarted.getCtrlData(currentLogicalCounter, HANDLE1);
+        CHECK(sector < restarted.getCtrlData(numberOfSectors, HANDLE1));
+        storage.stuckAddr = EEPRWL_HostProbe::sectorAddr(restarted, HANDLE1, sector);
+        CHECK(restarted.writeAsync((uint32_t)999, HANDLE1));
+        runJob(restarted, result);
+        CHECK(result == EEPRWL_ASYNC_FAILED);
+        CHECK(restarted.asyncState() == EEPRWL_ASYNC_FAILED);
+        // The corrupt sector is the newest one, the records before it are intact
+        CHECK(!restarted.read(0, back, HANDLE1));
+        CHECK(restarted.readRelative(-1, back, HANDLE1) && back == value);
+        storage.stuckAddr = 0;
+
+        // A failed job does not block the next one
+        CHECK(restarted.writeAsync(value + 1, HANDLE1));
+        runJob(restarted, result);
+        CHECK(result == EEPRWL_ASYNC_DONE);
+        CHECK(restarted.read(0, back, HANDLE1) && back == value + 1);
+    }
+
+    EEProm_Safe_Wear_Level restarted(PartitionsData, storage);
+    restarted.config(0, PARTITION_SIZE, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    CHECK(restarted.read(0, back, HANDLE1) && back == value + 1);
+    CHECK(restarted.readRelative(-2, back, HANDLE1) && back == value);
+}
+
+// ----------------------------------------------------
+
+int main() {
+    testAsync();
+    return TEST_RESULT("test_async");
+}
@@ -0,0 +1,99 @@
+// #############################################
+// ####### Host test: delta encoding ###########
+// #############################################
+//
+// Record of 24 bytes in a partition with a payload of 6 bytes
+// (EEPRWL_DELTA): keyframe of 5 sectors, a small change is one
+// delta sector.
+//  1. keyframe and delta sectors, read(0) returns the RAM copy
+//  2. after a power cycle read(0) rebuilds the record from the newest
+//     keyframe and the deltas behind it
+//  3. writes after the restart continue the chain, also after the
+//     ring has wrapped
+//
+// Build: make (-DEEPRWL_DELTA=2)
+//
+
+#include "host_test.h"
+
+#if EEPRWL_DELTA < 1
+  #error "Build with -DEEPRWL_DELTA=2"
+#endif
+
+#define HANDLE1 0
+#define PARTITION_SIZE 400
+#define PAYLOAD_SIZE 6
+#define WRITE_CYCLES_PER_HOUR 255
+#define KEYFRAME_EVERY 8
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0
+#define numberOfSectors 8
+
+static uint8_t PartitionsData[16];
+
+struct Record { uint8_t b[24]; };
+
+// Partition as set up by the application after every (re)start
+static void setup(EEProm_Safe_Wear_Level& w) {
+    w.config(0, PARTITION_SIZE, PAYLOAD_SIZE, 2, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    CHECK(w.setDelta(true, KEYFRAME_EVERY, HANDLE1));
+}
+
+static bool same(const Record& a, const Record& b) { return memcmp(&a, &b, sizeof(Record)) == 0; }
+
+static void testDelta() {
+    HostEEPROM<512> eeprom;
+    Record rec, back;
+    memset(&rec, 0, sizeof(rec));
+
+    {
+        EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+        setup(EEPRWL);
+        CHECK(!EEPRWL.read(0, back, HANDLE1));   // empty partition
+
+        // 1. Keyframe: 24 bytes in chunks of 5, then one sector per small change
+        for (uint8_t k = 0; k < sizeof(rec); k++) rec.b[k] = k;
+        CHECK(EEPRWL.write(rec, HANDLE1));
+        CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == 5);
+        for (uint8_t i = 1; i <= 3; i++) {
+            rec.b[i * 5]++;
+            CHECK(EEPRWL.write(rec, HANDLE1));
+            CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == 5u + i);
+            CHECK(EEPRWL.read(0, back, HANDLE1) && same(back, rec));
+        }
+    }
+
+    // 2. Power cycle: keyframe and 3 deltas
+    {
+        EEProm_Safe_Wear_Level restarted(PartitionsData, eeprom.storage);
+        setup(restarted);
+        CHECK(restarted.read(0, back, HANDLE1) && same(back, rec));
+
+        // 3. The chain continues: more than one lap with periodic keyframes
+        uint16_t sectors = restarted.getCtrlData(numberOfSectors, HANDLE1);
+        for (uint16_t i = 0; i < 2 * sectors; i++) {
+            rec.b[i % sizeof(rec)] += 3;
+            if (i % 11 == 0) rec.b[(i * 7) % sizeof(rec)] ^= 0x55;
+            CHECK(restarted.write(rec, HANDLE1));
+        }
+        CHECK(restarted.getCtrlData(currentLogicalCounter, HANDLE1) > sectors);
+        CHECK(restarted.read(0, back, HANDLE1) && same(back, rec));
+    }
+
+    // Power cycle after the ring has wrapped
+    EEProm_Safe_Wear_Level restarted(PartitionsData, eeprom.storage);
+    setup(restarted);
+    CHECK(restarted.read(0, back, HANDLE1) && same(back, rec));
+    rec.b[0]++;
+    CHECK(restarted.write(rec, HANDLE1));
+
+    EEProm_Safe_Wear_Level again(PartitionsData, eeprom.storage);
+    setup(again);
+    CHECK(again.read(0, back, HANDLE1) && same(back, rec));
+}
+
+int main() {
+    testDelta();
+    return TEST_RESULT("test_delta");
+}
@@ -0,0 +1,82 @@
+// #############################################
+// ####### Host test: sector ECC ###############
+// #############################################
+//
+// SEC-DED check word of the sectors (EEPRWL_ECC):
+//  1. every single bit flip of a sector is corrected and counted
+//     (eccCorrected())
+//  2. a double bit flip is detected (eccUncorrectable()), never read
+//     as a wrong value
+//  3. a flipped bit in the newest sector does not mislead the head
+//     search of a restart
+//
+// Build: make (-DEEPRWL_ECC=1)
+//
+
+#include "host_test.h"
+
+#if EEPRWL_ECC < 1
+  #error "Build with -DEEPRWL_ECC=1"
+#endif
+
+#define HANDLE1 0
+#define PARTITION_SIZE 300
+#define WRITE_CYCLES_PER_HOUR 255
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0
+#define numberOfSectors 8
+
+static uint8_t PartitionsData[16];
+
+static void testEcc() {
+    HostEEPROM<512> eeprom;
+    uint32_t value, back;
+
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+    CHECK(EEPRWL.config(0, PARTITION_SIZE, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1) > 0);
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+    for (value = 1; value <= sectors + 5u; value++) CHECK(EEPRWL.write(value * 0x01010101UL, HANDLE1));
+    value = (value - 1) * 0x01010101UL;
+
+    // Newest record: counter sectors + 5 in sector (sectors + 4) % sectors
+    uint16_t addr = EEPRWL_HostProbe::sectorAddr(EEPRWL, HANDLE1, (sectors + 4) % sectors);
+    uint16_t bits = EEPRWL_HostProbe::sectorSize(EEPRWL, HANDLE1) * 8;
+    CHECK(EEPRWL.eccCorrected() == 0);
+
+    // 1. Single bit flips: payload, counter, check word and checksum
+    for (uint16_t b = 0; b < bits; b++) {
+        eeprom.mem[addr + b / 8] ^= 1 << (b % 8);
+        CHECK(EEPRWL.readRelative(0, back, HANDLE1) && back == value);
+        eeprom.mem[addr + b / 8] ^= 1 << (b % 8);
+    }
+    CHECK(EEPRWL.eccCorrected() == bits);
+    CHECK(EEPRWL.eccUncorrectable() == 0);
+
+    // 2. Double bit flips in the payload
+    uint32_t lost = 0;
+    for (uint16_t b = 0; b < 31; b++) {
+        eeprom.mem[addr + b / 8] ^= 1 << (b % 8);
+        eeprom.mem[addr + (b + 1) / 8] ^= 1 << ((b + 1) % 8);
+        if (!EEPRWL.readRelative(0, back, HANDLE1)) lost++;
+        else CHECK(back == value);
+        eeprom.mem[addr + b / 8] ^= 1 << (b % 8);
+        eeprom.mem[addr + (b + 1) / 8] ^= 1 << ((b + 1) % 8);
+    }
+    CHECK(lost == 31);
+    CHECK(EEPRWL.eccUncorrectable() >= lost);   // counts the sector reads
+    CHECK(EEPRWL.eccCorrected() == bits);
+
+    // 3. Restart with a flipped bit in the newest sector
+    eeprom.mem[addr + 1] ^= 0x10;
+    EEProm_Safe_Wear_Level restarted(PartitionsData, eeprom.storage);
+    restarted.config(0, PARTITION_SIZE, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    CHECK(restarted.getCtrlData(currentLogicalCounter, HANDLE1) == sectors + 5u);
+    CHECK(restarted.read(0, back, HANDLE1) && back == value);
+    CHECK(restarted.eccCorrected() > 0);
+}
+
+int main() {
+    testEcc();
+    return TEST_RESULT("test_ecc");
+}
@@ -0,0 +1,384 @@
+// #############################################
+// ####### Host test: engine ###################
+// #############################################
+//
+// Wear-leveling engine on EEPRWL_RamStorage:
+//  1. write/read round trip, head restore after re-construction
+//  2. counter rollover (cntLengthBytes = 1)
+//  3. lazy format (format epochs), corrupted sector read as an earlier epoch
+//  4. writeBatch(), readByCounter(), forEachRecord()
+//  5. writeBatch() with a failed verify (stuck byte, zero-filled gap)
+//  6. partitions of earlier library versions are used unchanged
+//
+
+#include "host_test.h"
+
+#define HANDLE1 0
+#define WRITE_CYCLES_PER_HOUR 255
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0
+#define numberOfSectors 8
+#define formatEpoch 13
+#define status 14
+
+static uint8_t PartitionsData[16 * 2];
+
+// ----------------------------------------------------
+// --- 1. ROUND TRIP AND HEAD RESTORE ---
+// ----------------------------------------------------
+
+static void testRoundTrip() {
+    HostEEPROM<1024> eeprom;
+    struct Record { uint16_t id; int16_t value; uint8_t flags; } rec = {0, 0, 0}, back;
+
+    {
+        EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+        CHECK(EEPRWL.config(0, 300, sizeof(Record), 3, WRITE_CYCLES_PER_HOUR, HANDLE1) > 0);
+        CHECK(!EEPRWL.read(0, back, HANDLE1));   // empty partition
+
+        uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+        // More than two laps: the ring wraps, the head is in the middle
+        for (uint16_t i = 1; i <= 2 * sectors + sectors / 3; i++) {
+            rec.id = i; rec.value = -i; rec.flags = i & 0xFF;
+            CHECK(EEPRWL.write(rec, HANDLE1));
+            CHECK(EEPRWL.read(0, back, HANDLE1) && back.id == i && back.value == -i);
+        }
+    }
+
+    // Re-construction: config() restores the head from the EEPROM
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+    CHECK(EEPRWL.config(0, 300, sizeof(Record), 3, WRITE_CYCLES_PER_HOUR, HANDLE1) > 0);
+    CHECK(EEPRWL.read(0, back, HANDLE1) && back.id == rec.id && back.value == rec.value && back.flags == rec.flags);
+    CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == rec.id);
+
+    // The next write continues behind the restored head
+    rec.id++;
+    CHECK(EEPRWL.write(rec, HANDLE1));
+    CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == rec.id);
+}
+
+// ----------------------------------------------------
+// --- 2. COUNTER ROLLOVER ---
+// ----------------------------------------------------
+
+static void testRollover() {
+    HostEEPROM<512> eeprom;
+    uint16_t value = 0, back;
+
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+    EEPRWL.config(0, 200, sizeof(value), 1, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+    uint16_t overw = EEPRWL.getOverwCounter(HANDLE1);
+    // 1-byte counter: capacity = whole laps below 255
+    uint32_t capacity = (255 / sectors) * sectors;
+
+    for (value = 1; value <= 3 * capacity + 5; value++) {
+        CHECK(EEPRWL.write(value, HANDLE1));
+    }
+    value--;
+    CHECK(EEPRWL.getOverwCounter(HANDLE1) == overw + 3);
+    CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == 5);
+    CHECK(EEPRWL.read(0, back, HANDLE1) && back == value);
+
+    // The newest record across the rollover is found after a restart
+    EEProm_Safe_Wear_Level restarted(PartitionsData, eeprom.storage);
+    restarted.config(0, 200, sizeof(value), 1, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    CHECK(restarted.read(0, back, HANDLE1) && back == value);
+    CHECK(restarted.readRelative(-(int32_t)(sectors - 1), back, HANDLE1) && back == value - sectors + 1);
+}
+
+// ----------------------------------------------------
+// --- 3. LAZY FORMAT ---
+// ----------------------------------------------------
+
+static void testLazyFormat() {
+    HostEEPROM<512> eeprom;
+    uint32_t value, back;
+
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+    EEPRWL.config(0, 400, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+    for (value = 1; value <= sectors; value++) EEPRWL.write(value, HANDLE1);
+
+    for (uint8_t f = 1; f <= EEPRWL_LAZY_FORMAT + 1; f++) {
+        uint32_t cycles = eeprom.storage.writeCycles;
+        CHECK(EEPRWL.initialize(1, HANDLE1));
+        cycles = eeprom.storage.writeCycles - cycles;
+
+        if (f <= EEPRWL_LAZY_FORMAT) {
+            // Lazy: next epoch, only the metadata is written
+            CHECK(EEPRWL.getCtrlData(formatEpoch, HANDLE1) % 256 == f);
+            CHECK(cycles < METADATA_SIZE + 16);
+        } else {
+            // After EEPRWL_LAZY_FORMAT lazy formats: zero-fill, epoch 0
+            CHECK(EEPRWL.getCtrlData(formatEpoch, HANDLE1) % 256 == 0);
+            CHECK(cycles > sectors);
+        }
+        CHECK(EEPRWL.getCtrlData(status, HANDLE1) % 256 == 4);
+        CHECK(!EEPRWL.read(0, back, HANDLE1));
+        CHECK(!EEPRWL.readRelative(-1, back, HANDLE1));
+
+        // The old records stay invisible after a restart as well
+        EEProm_Safe_Wear_Level restarted(PartitionsData, eeprom.storage);
+        restarted.config(0, 400, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+        CHECK(restarted.getCtrlData(currentLogicalCounter, HANDLE1) == 0);
+
+        // Half a ring of new records: the rest of the ring holds old epochs
+        for (value = 1; value <= (uint32_t)sectors / 2; value++) CHECK(restarted.write(value + 1000 * f, HANDLE1));
+        CHECK(restarted.findOldestData(HANDLE1) && restarted.read(0, back, HANDLE1) && back == 1 + 1000u * f);
+        CHECK(restarted.findNewestData(HANDLE1) && restarted.read(0, back, HANDLE1) && back == sectors / 2 + 1000u * f);
+        EEPRWL.config(0, 400, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    }
+}
+
+#if EEPRWL_LAZY_FORMAT >= 3
+// A corrupted record of the current epoch whose checksum matches an earlier epoch:
+// the head search must not stop in front of it
+static void testStaleSector() {
+    HostEEPROM<512> eeprom;
+    uint32_t value, back;
+
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+    EEPRWL.config(0, 400, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+    for (value = 1; value <= sectors; value++) EEPRWL.write(value, HANDLE1);
+    for (uint8_t f = 0; f < 3; f++) EEPRWL.initialize(1, HANDLE1);
+    CHECK(EEPRWL.getCtrlData(formatEpoch, HANDLE1) % 256 == 3);
+
+    // First lap of epoch 3 beyond the middle sector (first probe of the binary search)
+    uint16_t middle = sectors / 2;
+    for (value = 1; value <= middle + 5u; value++) EEPRWL.write(value, HANDLE1);
+
+    // Checksum of the middle sector as if written in epoch 0 (two bits: not correctable)
+    uint16_t secSize = EEPRWL_HostProbe::sectorSize(EEPRWL, HANDLE1);
+    eeprom.mem[EEPRWL_HostProbe::sectorAddr(EEPRWL, HANDLE1, middle) + secSize - CRC_LEN] ^= 3;
+
+    EEProm_Safe_Wear_Level restarted(PartitionsData, eeprom.storage);
+    restarted.config(0, 400, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    CHECK(restarted.getCtrlData(currentLogicalCounter, HANDLE1) == middle + 5u);
+    CHECK(restarted.read(0, back, HANDLE1) && back == middle + 5u);
+    CHECK(restarted.findOldestData(HANDLE1) && restarted.read(0, back, HANDLE1) && back == 1);
+    CHECK(restarted.findNewestData(HANDLE1) && restarted.read(0, back, HANDLE1) && back == middle + 5u);
+    CHECK(!restarted.readByCounter(middle + 1, back, HANDLE1));
+    CHECK(restarted.readByCounter(middle + 2, back, HANDLE1) && back == middle + 2u);
+}
+#endif
+
+// ----------------------------------------------------
+// --- 4. BATCH, RANDOM ACCESS AND STREAMING ---
+// ----------------------------------------------------
+
+struct Collected {
+    uint32_t first, last;
+    uint16_t count;
+    bool ordered;
+};
+
+static bool collect(const uint8_t* payload, uint32_t counter, void* context) {
+    Collected* c = (Collected*)context;
+    uint32_t value;
+    memcpy(&value, payload, sizeof(value));
+    if (c->count == 0) c->first = value;
+    else if (value != c->last + 1 || counter != value) c->ordered = false;
+    c->last = value;
+    c->count++;
+    return true;
+}
+
+static void testBatchAndLog() {
+    HostEEPROM<512> eeprom;
+    uint32_t records[20], back;
+
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+    EEPRWL.config(0, 400, sizeof(back), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+
+    // Batches until the ring has wrapped; payload = logical counter
+    uint32_t next = 1;
+    while (next <= 2u * sectors) {
+        for (uint8_t i = 0; i < 20; i++) records[i] = next + i;
+        CHECK(EEPRWL.writeBatch(records, 20, HANDLE1) == 20);
+        next += 20;
+    }
+    uint32_t newest = next - 1;
+    CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == newest);
+    CHECK(EEPRWL.read(0, back, HANDLE1) && back == newest);
+
+    // Random access: the whole ring, nothing older
+    CHECK(EEPRWL.readByCounter(newest - sectors + 1, back, HANDLE1) && back == newest - sectors + 1);
+    CHECK(EEPRWL.readByCounter(newest - sectors / 2, back, HANDLE1) && back == newest - sectors / 2);
+    CHECK(!EEPRWL.readByCounter(newest - sectors, back, HANDLE1));
+    CHECK(EEPRWL.getCtrlData(status, HANDLE1) % 256 == 15);
+    CHECK(!EEPRWL.readByCounter(newest + 1, back, HANDLE1));
+
+    // Streaming: oldest to newest, and the newest 5 to older records
+    Collected all = {0, 0, 0, true};
+    CHECK(EEPRWL.forEachRecord(3, 0, 1, collect, HANDLE1, &all) == sectors);
+    CHECK(all.ordered && all.first == newest - sectors + 1 && all.last == newest);
+
+    Collected recent = {0, 0, 0, true};
+    CHECK(EEPRWL.forEachRecord(4, 5, 2, collect, HANDLE1, &recent) == 5);
+    CHECK(recent.first == newest && recent.last == newest - 4);
+
+    // The batch survives a restart
+    EEProm_Safe_Wear_Level restarted(PartitionsData, eeprom.storage);
+    restarted.config(0, 400, sizeof(back), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    CHECK(restarted.read(0, back, HANDLE1) && back == newest);
+    CHECK(restarted.readRelative(-10, back, HANDLE1) && back == newest - 10);
+}
+
+// ----------------------------------------------------
+// --- 5. BATCH WITH A FAILED VERIFY ---
+// ----------------------------------------------------
+
+#if EEPRWL_SPARE_SECTORS == 0
+// (with spare sectors the stuck sector is retired and the batch completes)
+static void testBatchFailure() {
+    uint8_t memory[512];
+    memset(memory, 0xFF, sizeof(memory));   // erased EEPROM
+    StuckStorage storage(memory, sizeof(memory));
+    uint32_t records[20], back;
+
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, storage);
+    EEPRWL.config(0, 400, sizeof(back), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+
+    // One and a half laps: the batch overwrites older records
+    uint32_t value;
+    for (value = 1; value <= sectors + sectors / 2; value++) CHECK(EEPRWL.write(value, HANDLE1));
+    uint32_t head = value - 1;
+
+    // Stuck byte in the 6th sector of the batch (counter c is written to sector (c - 1) % sectors)
+    storage.stuckAddr = EEPRWL_HostProbe::sectorAddr(EEPRWL, HANDLE1, (head + 5) % sectors);
+    for (uint8_t i = 0; i < 20; i++) records[i] = head + 1 + i;
+    CHECK(EEPRWL.writeBatch(records, 20, HANDLE1) == 5);
+    storage.stuckAddr = 0;
+
+    // The head stands at the last verified record, the tail is not readable
+    CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == head + 5);
+    CHECK(EEPRWL.read(0, back, HANDLE1) && back == head + 5);
+    CHECK(!EEPRWL.readByCounter(head + 6, back, HANDLE1));
+    CHECK(!EEPRWL.readByCounter(head + 20, back, HANDLE1));
+    Collected all = {0, 0, 0, true};
+    CHECK(EEPRWL.forEachRecord(3, 0, 1, collect, HANDLE1, &all) == sectors - 15);
+    CHECK(all.ordered && all.last == head + 5);
+
+    // A restart finds the same head
+    {
+        EEProm_Safe_Wear_Level restarted(PartitionsData, storage);
+        restarted.config(0, 400, sizeof(back), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+        CHECK(restarted.getCtrlData(currentLogicalCounter, HANDLE1) == head + 5);
+        CHECK(restarted.read(0, back, HANDLE1) && back == head + 5);
+        CHECK(!restarted.readByCounter(head + 10, back, HANDLE1));
+    }
+
+    // The next records continue behind the committed ones
+    for (uint8_t i = 0; i < 20; i++) records[i] = head + 6 + i;
+    CHECK(EEPRWL.writeBatch(records, 20, HANDLE1) == 20);
+    EEProm_Safe_Wear_Level restarted(PartitionsData, storage);
+    restarted.config(0, 400, sizeof(back), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    CHECK(restarted.read(0, back, HANDLE1) && back == head + 25);
+    CHECK(restarted.readByCounter(head + 6, back, HANDLE1) && back == head + 6);
+}
+
+// A cell that fails once: the failed sector and the tail are cleanly zero-filled, an empty
+// gap lies between the head and the previous lap
+static void testBatchGap() {
+    uint8_t memory[512];
+    memset(memory, 0xFF, sizeof(memory));   // erased EEPROM
+    StuckStorage storage(memory, sizeof(memory));
+    uint32_t records[20], back;
+
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, storage);
+    EEPRWL.config(0, 400, sizeof(back), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+
+    uint32_t value;
+    for (value = 1; value <= sectors + sectors / 2; value++) CHECK(EEPRWL.write(value, HANDLE1));
+    uint32_t head = value - 1;
+
+    storage.stuckAddr = EEPRWL_HostProbe::sectorAddr(EEPRWL, HANDLE1, (head + 5) % sectors);
+    storage.stuckWrites = 1;
+    for (uint8_t i = 0; i < 20; i++) records[i] = head + 1 + i;
+    CHECK(EEPRWL.writeBatch(records, 20, HANDLE1) == 5);
+    CHECK(storage.stuckWrites == 0);
+
+    // Behind the gap of 15 sectors: the older records of the previous lap
+    uint32_t oldest = head + 5 - (sectors - 15) + 1;
+    CHECK(EEPRWL.findOldestData(HANDLE1) && EEPRWL.read(0, back, HANDLE1) && back == oldest);
+    Collected all = {0, 0, 0, true};
+    CHECK(EEPRWL.forEachRecord(3, 0, 1, collect, HANDLE1, &all) == sectors - 15);
+    CHECK(all.ordered && all.first == oldest && all.last == head + 5);
+
+    // After a restart: the same head and the same oldest record
+    EEProm_Safe_Wear_Level restarted(PartitionsData, storage);
+    restarted.config(0, 400, sizeof(back), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    CHECK(restarted.getCtrlData(currentLogicalCounter, HANDLE1) == head + 5);
+    CHECK(restarted.findOldestData(HANDLE1) && restarted.read(0, back, HANDLE1) && back == oldest);
+    CHECK(restarted.findNewestData(HANDLE1) && restarted.read(0, back, HANDLE1) && back == head + 5);
+    CHECK(restarted.readByCounter(oldest, back, HANDLE1) && back == oldest);
+    CHECK(!restarted.readByCounter(oldest - 1, back, HANDLE1));
+}
+
+#endif
+
+// ----------------------------------------------------
+// --- 6. LAYOUT OF EARLIER LIBRARY VERSIONS ---
+// ----------------------------------------------------
+
+#if EEPRWL_HEAD_HINTS == 0 && EEPRWL_META_RING == 0 && EEPRWL_SPARE_SECTORS == 0 && EEPRWL_ECC == 0 && CRC_LEN == 1
+// Image as written by the earlier versions: Magic ID 0x49, layout hash, overwrite
+// counter (4 bytes), then sectors of payload, counter (LE) and CRC-8
+static void testEarlierLayout() {
+    HostEEPROM<512> eeprom;
+    const uint16_t size = 200, sectors = (size - 4) / (4 + 3 + 1);
+    uint8_t hash[7] = {0, 0, 4, 0, (uint8_t)sectors, 0, 3};
+
+    eeprom.mem[0] = 0x49;
+    eeprom.mem[1] = eeprwlCrc8(hash, 7);
+    eeprom.mem[2] = 5; eeprom.mem[3] = 0;
+    for (uint32_t c = 1; c <= sectors + 6u; c++) {
+        uint8_t* sec = &eeprom.mem[4 + ((c - 1) % sectors) * 8];
+        uint32_t value = c * 7;
+        memcpy(sec, &value, 4);
+        sec[4] = (uint8_t)c; sec[5] = (uint8_t)(c >> 8); sec[6] = (uint8_t)(c >> 16);
+        sec[7] = eeprwlCrc8(sec, 7);
+    }
+
+    uint32_t back;
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+    CHECK(EEPRWL.config(0, size, sizeof(back), 3, WRITE_CYCLES_PER_HOUR, HANDLE1) > 0);
+    CHECK(EEPRWL.getCtrlData(status, HANDLE1) % 256 != 4);   // not formatted
+    CHECK(EEPRWL.getCtrlData(numberOfSectors, HANDLE1) == sectors);
+    CHECK(EEPRWL.getOverwCounter(HANDLE1) == 5);
+    CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == sectors + 6u);
+    CHECK(EEPRWL.read(0, back, HANDLE1) && back == (sectors + 6u) * 7);
+    CHECK(EEPRWL.readRelative(-(int32_t)(sectors - 1), back, HANDLE1) && back == 7u * 7);
+
+    // New records continue the ring
+    CHECK(EEPRWL.write((uint32_t)1234, HANDLE1));
+    CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == sectors + 7u);
+    CHECK(eeprom.mem[0] == 0x49);
+}
+#endif
+
+// ----------------------------------------------------
+
+int main() {
+    testRoundTrip();
+    testRollover();
+    testLazyFormat();
+#if EEPRWL_LAZY_FORMAT >= 3
+    testStaleSector();
+#endif
+    testBatchAndLog();
+#if EEPRWL_SPARE_SECTORS == 0
+    testBatchFailure();
+    testBatchGap();
+#endif
+#if EEPRWL_HEAD_HINTS == 0 && EEPRWL_META_RING == 0 && EEPRWL_SPARE_SECTORS == 0 && EEPRWL_ECC == 0 && CRC_LEN == 1
+    testEarlierLayout();
+#endif
+    return TEST_RESULT("test_engine");
+}
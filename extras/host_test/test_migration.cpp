@@ -0,0 +1,119 @@
+// #############################################
+// ####### Host test: migration resume #########
+// #############################################
+//
+// Incremental migration with a stored job (EEPRWL_MIGRATE_JOB):
+//  1. migrateBegin() / a partial migrateStep(), then a restart
+//  2. the rebuilt engine resumes the job from the target head
+//  3. the target holds exactly the job: counters 1 ... count, the
+//     records in source order, none copied twice or skipped
+//
+// Build: make (-DEEPRWL_MIGRATE_JOB=1)
+//
+
+#include "host_test.h"
+
+#if EEPRWL_MIGRATE_JOB < 1
+  #error "Build with -DEEPRWL_MIGRATE_JOB=1"
+#endif
+
+#define SOURCE 0
+#define TARGET 1
+#define WRITE_CYCLES_PER_HOUR 255
+#define RECORDS 20
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0
+#define numberOfSectors 8
+
+static uint8_t PartitionsData[16 * 2];
+
+// Partitions as set up by the application after every (re)start
+static void setup(EEProm_Safe_Wear_Level& w) {
+    w.config(0, 300, sizeof(uint32_t), 2, WRITE_CYCLES_PER_HOUR, SOURCE);
+    w.config(300, 400, sizeof(uint32_t), 2, WRITE_CYCLES_PER_HOUR, TARGET);
+}
+
+struct Collected {
+    uint32_t first, last;
+    uint16_t count;
+    bool ordered;
+};
+
+static bool collect(const uint8_t* payload, uint32_t counter, void* context) {
+    Collected* c = (Collected*)context;
+    uint32_t value;
+    memcpy(&value, payload, sizeof(value));
+    if (c->count == 0) c->first = value;
+    else if (value != c->last + 1) c->ordered = false;
+    c->last = value;
+    c->count++;
+    (void)counter;
+    return true;
+}
+
+static void testResume() {
+    HostEEPROM<1024> eeprom;
+    uint32_t value, back;
+    uint32_t newest;
+
+    {
+        EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+        setup(EEPRWL);
+        CHECK(EEPRWL.migratePending() == 0);
+
+        // One and a half laps in the source: the job spans the ring end
+        uint16_t sectors = EEPRWL.getCtrlData(numberOfSectors, SOURCE);
+        for (value = 1; value <= sectors + sectors / 2; value++) CHECK(EEPRWL.write(value, SOURCE));
+        newest = value - 1;
+
+        // 1. Partial copy
+        CHECK(EEPRWL.migrateBegin(SOURCE, TARGET, RECORDS));
+        CHECK(EEPRWL.migratePending() == RECORDS);
+        CHECK(EEPRWL.migrateStep(7) == 7);
+        CHECK(EEPRWL.migratePending() == RECORDS - 7);
+        CHECK(EEPRWL.getCtrlData(currentLogicalCounter, TARGET) == 7);
+    }
+
+    // 2. Restart: the job continues behind the target head
+    uint32_t first = newest - RECORDS + 1;
+    {
+        EEProm_Safe_Wear_Level restarted(PartitionsData, eeprom.storage);
+        setup(restarted);
+        CHECK(restarted.migratePending() == RECORDS - 7);
+        CHECK(restarted.getCtrlData(currentLogicalCounter, TARGET) == 7);
+        CHECK(restarted.read(0, back, TARGET) && back == first + 6);
+
+        // A second partial step and restart
+        CHECK(restarted.migrateStep(5) == 5);
+        CHECK(restarted.migratePending() == RECORDS - 12);
+    }
+
+    EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+    setup(EEPRWL);
+    CHECK(EEPRWL.migratePending() == RECORDS - 12);
+    for (uint8_t i = 0; i < 10 && EEPRWL.migratePending() > 0; i++) EEPRWL.migrateStep(3);
+    CHECK(EEPRWL.migratePending() == 0);
+
+    // 3. Target counters 1 ... RECORDS, each record once and in source order
+    CHECK(EEPRWL.getCtrlData(currentLogicalCounter, TARGET) == RECORDS);
+    for (uint32_t c = 1; c <= RECORDS; c++) {
+        CHECK(EEPRWL.readByCounter(c, back, TARGET) && back == first + c - 1);
+    }
+    CHECK(!EEPRWL.readByCounter(RECORDS + 1, back, TARGET));
+    Collected all = {0, 0, 0, true};
+    CHECK(EEPRWL.forEachRecord(3, 0, 1, collect, TARGET, &all) == RECORDS);
+    CHECK(all.ordered && all.first == first && all.last == newest);
+
+    // The source is unchanged, the finished job is not resumed again
+    CHECK(EEPRWL.read(0, back, SOURCE) && back == newest);
+    EEProm_Safe_Wear_Level restarted(PartitionsData, eeprom.storage);
+    setup(restarted);
+    CHECK(restarted.migratePending() == 0);
+    CHECK(restarted.getCtrlData(currentLogicalCounter, TARGET) == RECORDS);
+}
+
+int main() {
+    testResume();
+    return TEST_RESULT("test_migration");
+}
@@ -0,0 +1,84 @@
+// #############################################
+// ####### Host test: sector retirement ########
+// #############################################
+//
+// Spare sectors (EEPRWL_SPARE_SECTORS) on a stuck cell:
+//  1. the failing ring sector is retired, the record is written into
+//     its spare and write() succeeds
+//  2. the ring stays complete over further laps (no lost record)
+//  3. after a restart the remap table is read back: retiredSectors()
+//     is 1, the ring and the head are intact, a format keeps the table
+//
+// Build: make (-DEEPRWL_SPARE_SECTORS=2)
+//
+
+#include "host_test.h"
+
+#if EEPRWL_SPARE_SECTORS < 1
+  #error "Build with -DEEPRWL_SPARE_SECTORS=2"
+#endif
+
+#define HANDLE1 0
+#define PARTITION_SIZE 300
+#define WRITE_CYCLES_PER_HOUR 255
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0
+#define numberOfSectors 8
+
+static uint8_t PartitionsData[16];
+static uint8_t memory[512];
+
+static void testRetirement() {
+    memset(memory, 0xFF, sizeof(memory));   // erased EEPROM
+    StuckStorage storage(memory, sizeof(memory));
+    uint32_t value, back;
+    uint16_t sectors;
+
+    {
+        EEProm_Safe_Wear_Level EEPRWL(PartitionsData, storage);
+        CHECK(EEPRWL.config(0, PARTITION_SIZE, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1) > 0);
+        sectors = EEPRWL.getCtrlData(numberOfSectors, HANDLE1);
+        CHECK(EEPRWL.retiredSectors(HANDLE1) == 0);
+        for (value = 1; value <= 3; value++) CHECK(EEPRWL.write(value, HANDLE1));
+
+        // 1. Stuck cell in the payload of sector 3, the next one to be written
+        uint16_t failing = EEPRWL_HostProbe::sectorAddr(EEPRWL, HANDLE1, 3);
+        storage.stuckAddr = failing + 1;
+        CHECK(EEPRWL.write(value, HANDLE1));
+        CHECK(EEPRWL.read(0, back, HANDLE1) && back == value);
+        CHECK(EEPRWL.retiredSectors(HANDLE1) == 1);
+        CHECK(EEPRWL_HostProbe::sectorAddr(EEPRWL, HANDLE1, 3) != failing);
+
+        // 2. Two more laps over the retired sector
+        for (value++; value <= 3u * sectors; value++) CHECK(EEPRWL.write(value, HANDLE1));
+        value--;
+        CHECK(EEPRWL.retiredSectors(HANDLE1) == 1);
+        for (uint16_t i = 0; i < sectors; i++) {
+            CHECK(EEPRWL.readRelative(-(int32_t)i, back, HANDLE1) && back == value - i);
+        }
+    }
+
+    // 3. Restart: the remap table is restored from the metadata
+    EEProm_Safe_Wear_Level restarted(PartitionsData, storage);
+    restarted.config(0, PARTITION_SIZE, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+    CHECK(restarted.getCtrlData(numberOfSectors, HANDLE1) == sectors);
+    CHECK(restarted.retiredSectors(HANDLE1) == 1);
+    CHECK(restarted.getCtrlData(currentLogicalCounter, HANDLE1) == value);
+    for (uint16_t i = 0; i < sectors; i++) {
+        CHECK(restarted.readRelative(-(int32_t)i, back, HANDLE1) && back == value - i);
+    }
+    CHECK(restarted.findOldestData(HANDLE1) && restarted.read(0, back, HANDLE1) && back == value - sectors + 1);
+
+    // A format keeps the table, the stuck cell stays unused
+    CHECK(restarted.initialize(1, HANDLE1));
+    CHECK(restarted.retiredSectors(HANDLE1) == 1);
+    for (value = 1; value <= sectors + 3u; value++) CHECK(restarted.write(value, HANDLE1));
+    CHECK(restarted.retiredSectors(HANDLE1) == 1);
+    CHECK(restarted.readByCounter(4, back, HANDLE1) && back == 4);
+}
+
+int main() {
+    testRetirement();
+    return TEST_RESULT("test_spare");
+}
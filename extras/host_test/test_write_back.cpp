@@ -0,0 +1,96 @@
+// #############################################
+// ####### Host test: write-back ###############
+// #############################################
+//
+// Write-back slot with a simulated millis():
+//  1. write() only stages the value (status 14), no EEPROM write
+//  2. idle() flushes the slot after EEPRWL_WRITE_BACK_MS, as one sector
+//  3. oneTickPassed() never writes (it may run in an interrupt)
+//  4. flush() writes at once, the value survives a restart
+//
+// Build: make (-DEEPRWL_WRITE_BACK=1)
+//
+
+#include "host_test.h"
+
+#if EEPRWL_WRITE_BACK < 1
+  #error "Build with -DEEPRWL_WRITE_BACK=1"
+#endif
+
+#define HANDLE1 0
+#define PARTITION_SIZE 300
+#define WRITE_CYCLES_PER_HOUR 255
+
+//Offset Definitions for PartitionsData
+#define currentLogicalCounter 0
+#define status 14
+
+static uint8_t PartitionsData[16];
+
+// Simulated clock, replaces the weak millis() of the library
+static unsigned long hostMillis = 0;
+unsigned long millis() { return hostMillis; }
+
+static void testWriteBack() {
+    HostEEPROM<512> eeprom;
+    uint32_t value, back;
+
+    {
+        EEProm_Safe_Wear_Level EEPRWL(PartitionsData, eeprom.storage);
+        CHECK(EEPRWL.config(0, PARTITION_SIZE, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1) > 0);
+        CHECK(EEPRWL.write((uint32_t)100, HANDLE1));
+        CHECK(EEPRWL.setWriteBack(true, HANDLE1));
+        uint32_t records = EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1);
+
+        // 1. A burst is staged in RAM
+        uint32_t cycles = eeprom.storage.writeCycles;
+        for (value = 101; value <= 120; value++) {
+            CHECK(EEPRWL.write(value, HANDLE1));
+            CHECK(EEPRWL.getCtrlData(status, HANDLE1) % 256 == 14);
+        }
+        value--;
+        CHECK(eeprom.storage.writeCycles == cycles);
+        CHECK(EEPRWL.isDirty(HANDLE1));
+        CHECK(EEPRWL.read(0, back, HANDLE1) && back == value);
+
+        // 2. idle() keeps a value unsaved for less than EEPRWL_WRITE_BACK_MS
+        hostMillis += EEPRWL_WRITE_BACK_MS - 1;
+        EEPRWL.idle();
+        CHECK(eeprom.storage.writeCycles == cycles);
+        CHECK(EEPRWL.isDirty(HANDLE1));
+
+        // 3. Ticks do not write, also long after EEPRWL_WRITE_BACK_MS
+        for (uint8_t i = 0; i < 10; i++) {
+            hostMillis += EEPRWL_WRITE_BACK_MS;
+            EEPRWL.oneTickPassed();
+        }
+        CHECK(eeprom.storage.writeCycles == cycles);
+        CHECK(EEPRWL.isDirty(HANDLE1));
+
+        // idle() writes the due value, as one sector
+        EEPRWL.idle();
+        CHECK(!EEPRWL.isDirty(HANDLE1));
+        CHECK(eeprom.storage.writeCycles > cycles);
+        CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == records + 1);
+
+        // 4. flush() writes at once
+        CHECK(EEPRWL.write(++value, HANDLE1));
+        CHECK(EEPRWL.isDirty(HANDLE1));
+        CHECK(EEPRWL.flush());
+        CHECK(!EEPRWL.isDirty(HANDLE1));
+        CHECK(EEPRWL.getCtrlData(currentLogicalCounter, HANDLE1) == records + 2);
+    }
+
+    // Re-construction: the flushed value is the newest record
+    {
+        EEProm_Safe_Wear_Level restarted(PartitionsData, eeprom.storage);
+        restarted.config(0, PARTITION_SIZE, sizeof(value), 3, WRITE_CYCLES_PER_HOUR, HANDLE1);
+        CHECK(restarted.read(0, back, HANDLE1) && back == value);
+        CHECK(restarted.readRelative(-1, back, HANDLE1) && back == value - 1);
+    }
+}
+
+int main() {
+    testWriteBack();
+    return TEST_RESULT("test_write_back");
+}
@@ -17,10 +17,12 @@
  ******************************************************************************************************
  * EEProm_Safe_Wear_Level.cpp
  *
- * EEPROM MACROS:
+ * EEPROM MACROS (bound to the storage backend _io):
  * e_r	: read
  * e_w	: write
  * e_c	: commit
+ * e_rb	: block read
+ * e_wb	: block write
  ******************************************************************************************************
  */
 // =========================================================================
@@ -38,7 +40,8 @@
 // | 8   | 2    | numSecs    | uint16_t  | NUMBER OF SECTORS IN PARTITION |
 // | 10  | 1    | pldSize    | uint16_t  | PAYLOAD SIZE                   |
 // | 11  | 1    | cntLen     | uint8_t   | COUNTER LENGTH (e.g., 3 Bytes) |
-// | 12  | 2    | buckCyc    | uint16_t  | bucket cycles                  |
+// | 12  | 1    | buckCyc    | uint8_t   | bucket cycles                  |
+// | 13  | 1    | epoch      | uint8_t   | FORMAT EPOCH (lazy format)     |
 // | 14  | 1    | status     | uint8_t   | STATUS FLAG (0x00=OK, etc.)    |
 // | 15  | 1    | checksum   | uint16_t  | CHECKSUM (of the Control Block)|
 // +-----+------+------------+-----------+--------------------------------+
@@ -54,33 +57,171 @@
 //            in the header file (.h)!
 // ----------------------------------------------------------------------------------------------------
 #define DEFAULT_PLD_SIZE  1
-// Meta Data (size: magic-id(1) + config-hash(1) + Overwrite-counter(2)):
-#define METADATA_SIZE  4
-#define MAGIC_ID  0x49
+// Meta Data: HINT_SLOTS, HINT_ADDR and METADATA_SIZE see EEProm_Safe_Wear_Level_Macros.h
+// Magic ID, bits 4-6: format epoch (lazy format, EEPRWL_LAZY_FORMAT).
+// Without head hints the layout of the earlier versions (0x49).
+#define MAGIC_ID  (((EEPRWL_HEAD_HINTS > 0) ? 0x4D : 0x49) + CRC_FORMAT)
+#ifdef EEPRWL_IO_STATS
+uint32_t EEPRWL_ioReads = 0;
+uint32_t EEPRWL_ioWrites = 0;
+uint32_t EEPRWL_metaWrites = 0;
+#endif
+#if defined(ARDUINO)
+// Default storage backend: internal EEPROM
+EEPRWL_InternalEEPROM EEPRWL_internalEEPROM;
+#else
+#include <chrono>
+// Host build: default time base, can be replaced by the test application
+__attribute__((weak)) unsigned long millis() {
+    using namespace std::chrono;
+    static const steady_clock::time_point t0 = steady_clock::now();
+    return (unsigned long)duration_cast<milliseconds>(steady_clock::now() - t0).count();
+}
+__attribute__((weak)) unsigned long micros() {
+    using namespace std::chrono;
+    static const steady_clock::time_point t0 = steady_clock::now();
+    return (unsigned long)duration_cast<microseconds>(steady_clock::now() - t0).count();
+}
+#endif
+// Interrupt lock (see EEPRWL_LOCK), with optional measurement of the
+// longest interrupt-off window in EEPRWL_irqOffMax (microseconds)
+#ifdef EEPRWL_IRQ_STATS
+uint32_t EEPRWL_irqOffMax = 0;
+static uint32_t irqOffStart;
+static bool irqIsOff = false;
+static inline void irq_off() {
+    cli();
+    if (!irqIsOff) { irqIsOff = true; irqOffStart = micros(); }
+}
+static inline void irq_on() {
+    if (irqIsOff) {
+        uint32_t d = micros() - irqOffStart;
+        if (d > EEPRWL_irqOffMax) EEPRWL_irqOffMax = d;
+        irqIsOff = false;
+    }
+    sei();
+}
+#else
+     #define irq_off() cli()
+     #define irq_on() sei()
+#endif
+// Re-lock after a nested public call (its _end() enables the interrupts)
+#if EEPRWL_LOCK == EEPRWL_LOCK_SHORT
+     #define irq_relock()
+#else
+     #define irq_relock() irq_off()
+#endif
+// Result of readSector()
+#define SEC_CORRUPT  0
+#define SEC_VALID    1
+#define SEC_EMPTY    2
+#define SEC_STALE    3   // record of an earlier format epoch (unused, or a corrupted record)
+// Block size for formatting paged backends (stack buffer)
+#define FORMAT_BURST  32
+// Phases of the asynchronous write engine
+#define ASYNC_SECTOR  0
+#define ASYNC_VERIFY  1
+#define ASYNC_HINT    2
+#define ASYNC_END     3
+
+#if defined(EEPRWL_ASYNC_ISR)
+// Instance with the pending asynchronous write (internal EEPROM)
+EEProm_Safe_Wear_Level* EEPRWL_asyncOwner = 0;
+
+#if defined(EE_READY_vect)
+#define ASYNC_IRQ
+ISR(EE_READY_vect) {
+    if (EEPRWL_asyncOwner == 0 || EEPRWL_asyncOwner->asyncStep() != EEPRWL_ASYNC_BUSY) EECR &= ~(1 << EERIE);
+}
+#endif
+#endif
 
 // ----------------------------------------------------------------------------------------------------
 // --- CONSTRUCTOR ---
 // ----------------------------------------------------------------------------------------------------
+#if defined(ARDUINO)
 EEProm_Safe_Wear_Level::EEProm_Safe_Wear_Level(uint8_t* ramHandlePtr, uint16_t seconds)
-    : _ramStart(ramHandlePtr), // Stores the passed pointer
-      _ioBufSize(8),
+    : EEProm_Safe_Wear_Level(ramHandlePtr, EEPRWL_internalEEPROM, seconds)
+{
+}
+#endif
+
+EEProm_Safe_Wear_Level::EEProm_Safe_Wear_Level(uint8_t* ramHandlePtr, EEPRWL_Storage& storage, uint16_t seconds)
+    : _io(&storage),
       _ioBuf(new uint8_t [8]),
+      _lastBuf(new uint8_t [8]),
       _buckPerm(new uint8_t [8]),
       _budgetCycles(new uint8_t [8]),
       _buckTime(millis()),
+      _tbCnt((3600/seconds)|1),
+      _tbCntN((3600/seconds)|1),
+      _tbCntLong(seconds),
       _bucketStartAddr(),
       _ctlLen(0),
+      _ramStart(ramHandlePtr), // Stores the passed pointer
+      _ioBufSize(8),
       _secSize(0),
+      _hintInt(0),
       _maxLgcCnt(0),
       _handle(0xFF),
       _handle1(0xFF),
+      _lastHandle(0xFF),
       _usedSector(0),
-      _tbCnt((3600/seconds)|1),
-      _tbCntLong(seconds)
+      _clock(0),
+      _timeRes(1),
+      _asyncBuf(0),
+      _asyncBufSize(0),
+      _asyncState(EEPRWL_ASYNC_IDLE),
+      _migLeft(0),
+      _migSrc(0xFF),
+      _migResume(false)
 {
-      _bucketStartAddr = EEPROM.length() - 9; 
+#if EEPRWL_RECORD_CACHE > 0
+      memset(_recCnt, 0, sizeof(_recCnt));
+#endif
+#if EEPRWL_WRITE_BACK > 0
+      _wbMode = 0; _wbDirty = 0; _wbForce = false;
+#endif
+#if EEPRWL_LAZY_INIT > 0
+      _restoring = 0; _rstPos = 0; _rstHandle = 0xFF;
+#endif
+#if EEPRWL_TOKEN_BUCKETS > 0
+      memset(_tkBurst, 0, sizeof(_tkBurst));
+      _tkClock = 0; _tkRest = 0; _tkMillis = millis();
+#endif
+#if EEPRWL_PRIORITY_POOL > 0
+      _prioMap = 0x55555555UL;   // all EEPRWL_PRIO_NORMAL
+      memset(_prioShed, 0, sizeof(_prioShed));
+      memset(_prioDone, 0, sizeof(_prioDone));
+      _prioPool = EEPRWL_PRIORITY_POOL;
+#endif
+#if EEPRWL_SPARE_SECTORS > 0
+      _remapHandle = 0xFF;
+#endif
+#if EEPRWL_ECC > 0
+      _eccFixed = 0; _eccLost = 0;
+#endif
+#if EEPRWL_DELTA > 0
+      _dtMode = 0; _dtKnown = 0;
+#endif
+      _bucketStartAddr = e_len - WLM_SIZE; 
+#if EEPRWL_META_RING > 0
+      // Newest valid record of the WLM ring, none: all cells as erased
+      _wlmStates = 0xFF; _wlmSeq = 0;
+      bool found = false;
+      for (uint8_t r = 0; r < WLM_SIZE / WLM_REC; r++) {
+            uint8_t rec[WLM_REC];
+            e_rb(_bucketStartAddr + r * WLM_REC, rec, WLM_REC);
+            if (rec[2] != (uint8_t)calculateCRC(rec, 2)) continue;
+            if (!found || (int8_t)(rec[1] - _wlmSeq) > 0) { _wlmStates = rec[0]; _wlmSeq = rec[1]; found = true; }
+      }
+#endif
       for (uint8_t i = 0; i < 8; i++) { 
+#if EEPRWL_META_RING > 0
+	    _buckPerm[i] = (_wlmStates & (1 << i)) ? 127 : 0;
+#else
 	    _buckPerm[i] = e_r(_bucketStartAddr+i);
+#endif
 
             // i need the hamming distance for error
             // correction of the original stored values
@@ -96,6 +237,19 @@ EEProm_Safe_Wear_Level::EEProm_Safe_Wear_Level(uint8_t* ramHandlePtr, uint16_t s
 	    _buckPerm[i] = _buckPerm[i]&128 == 128 ? 64 : c0 < c1 ? 127 : 0;
             _budgetCycles[i] = 0;
       }
+
+#if EEPRWL_MIGRATE_JOB > 0
+      // Interrupted migration: continued by migrateStep() once the partitions are configured
+      uint8_t job[MIGRATE_JOB_SIZE];
+      e_rb(_bucketStartAddr - MIGRATE_JOB_SIZE, job, MIGRATE_JOB_SIZE);
+      if (job[0] != 0xFF && job[12] == (uint8_t)calculateCRC(job, 12)) {
+            _migSrc = job[0]; _migTgt = job[1];
+            _migLeft = readLE(&job[2], 2);
+            _migNext = readLE(&job[4], 4);
+            _migBase = readLE(&job[8], 4);
+            _migResume = true;
+      }
+#endif
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -103,9 +257,9 @@ EEProm_Safe_Wear_Level::EEProm_Safe_Wear_Level(uint8_t* ramHandlePtr, uint16_t s
 // ----------------------------------------------------------------------------------------------------
 
 // Returns: Overwrite number of the partition
-uint16_t EEProm_Safe_Wear_Level::config(uint16_t startAddress, uint16_t totalBytesUsed, uint8_t PayloadSize, uint8_t cntLengthBytes, uint8_t budgetCycles, uint8_t handle) {
+uint16_t EEProm_Safe_Wear_Level::config(uint16_t startAddress, uint16_t totalBytesUsed, uint8_t PayloadSize, uint8_t cntLengthBytes, uint8_t budgetCycles, uint8_t handle, uint8_t timeBytes) {
      
-     if (startAddress+totalBytesUsed >= _bucketStartAddr) totalBytesUsed = _bucketStartAddr-startAddress;
+     if (startAddress+totalBytesUsed >= _bucketStartAddr - MIGRATE_JOB_SIZE) totalBytesUsed = _bucketStartAddr - MIGRATE_JOB_SIZE - startAddress;
 
      // Calculates the pointer to the start of the partition in the RAM Handle
      uint8_t* ramPtr = _ramStart + ((size_t)handle * CONTROL_STRUCT_SIZE);
@@ -115,16 +269,31 @@ uint16_t EEProm_Safe_Wear_Level::config(uint16_t startAddress, uint16_t totalByt
 
      _buckCyc = budgetCycles;
      //_buckPerm[handle>>5] = 60;   // for testing
+#if EEPRWL_TOKEN_BUCKETS > 0
+     if (handle < EEPRWL_TOKEN_BUCKETS) {
+         // Rate and depth of the shared credit buckets: budgetCycles writes per hour, 255 hours
+         uint8_t per = (budgetCycles > 0) ? budgetCycles : 1;
+         _tkRate[handle] = (uint16_t)per << 4;
+         _tkBurst[handle] = 255 * per;
+         _tkStamp[handle] = _tkClock;
+         tokenFill(handle);
+     }
+#endif
 
     uint16_t success = 1; _startAddr = startAddress;
-    _cntLen = min(cntLengthBytes, 4);
-    _ctlLen = _cntLen + 1;
+    // Counter and timestamp length share one byte of the control data
+    _cntCfg = ((cntLengthBytes > 4) ? 4 : cntLengthBytes) | (((timeBytes > 4) ? 4 : timeBytes) << 4);
+    _ctlLen = _cntLen + _tsLen + ECC_LEN + CRC_LEN;
 
     // 1. Check and set payload size
     _pldSize = (PayloadSize < DEFAULT_PLD_SIZE) ? DEFAULT_PLD_SIZE : PayloadSize;
 
+    // Calculate the exact sector size and the placement in the pages of the backend
+    _secSize = _pldSize + _ctlLen;
+    pageGeometry();
+
     // Calculation of the maximum possible physical sectors
-    _numSecs = (totalBytesUsed - METADATA_SIZE) / (_pldSize + _ctlLen);
+    _numSecs = sectorCount(startAddress, totalBytesUsed, _secSize, _io->pageSize());
 
     // If at least 1 sector is not calculated, it must terminate with an
     // error!
@@ -132,25 +301,45 @@ uint16_t EEProm_Safe_Wear_Level::config(uint16_t startAddress, uint16_t totalByt
 
     // Ensures that the rollout is triggered exactly after a full number of
     // rotations. With adjustment for the sector counter size.
-     #define maxCapacity (uint32_t)(1UL << (_cntLen * 8)) - 1
-    _maxLgcCnt = ((maxCapacity) / _numSecs) * _numSecs;
+    _maxLgcCnt = counterLimit(_cntLen, _numSecs);
 
-    // Calculate the exact sector size
-    _secSize = _pldSize + _ctlLen;
+    _hintInt = hintInterval(_numSecs);
 
     // Write address initially unknown
     _nextPhSec = 0;
+#if EEPRWL_SPARE_SECTORS > 0
+    // New layout: the remap table is loaded again
+    if (handle == _remapHandle) _remapHandle = 0xFF;
+#endif
 
     if (_ioBufSize < _secSize) {
         delete[] _ioBuf;
+        delete[] _lastBuf;
         _ioBuf = new uint8_t [_secSize]; //[((_secSize>>2)+1)<<2];
+        _lastBuf = new uint8_t [_secSize];
         _ioBufSize = _secSize;
+        _lastHandle = 0xFF;
     }
-
+    dropNewest(handle);
+#if EEPRWL_WRITE_BACK > 0
+    // New layout: the slot (and the mode) must be set up again
+    if (handle < EEPRWL_WRITE_BACK) { _wbMode &= ~(1 << handle); _wbDirty &= ~(1 << handle); }
+#endif
+#if EEPRWL_DELTA > 0
+    if (handle < EEPRWL_DELTA) { _dtMode &= ~(1 << handle); _dtKnown &= ~(1 << handle); }
+#endif
+
+#if EEPRWL_LAZY_INIT > 0
+    if (handle == _rstHandle) _rstPos = 0;
+    if (success > 0 && handle < 16) {
+        // Deferred restore: idle() or the first access
+        _restoring |= (1U << handle);
+    } else
+#endif
     if (success > 0) {
         _checksum = chkSum();
         initialize(false, handle);
-        success = ((uint16_t)e_r(_startAddr + 3) << 8 ) | e_r(_startAddr + 2);
+        success = overwCounter();
     }
 
     _checksum = chkSum();
@@ -161,67 +350,317 @@ uint16_t EEProm_Safe_Wear_Level::config(uint16_t startAddress, uint16_t totalByt
 // ----------------------------------------------------------------------------------------------------
 
 bool EEProm_Safe_Wear_Level::initialize(bool forceFormat, uint8_t handle) {
+#if EEPRWL_LAZY_INIT > 0
+    // Replaces a deferred restore of config()
+    if (handle < 16) _restoring &= ~(1U << handle);
+    if (handle == _rstHandle) _rstPos = 0;
+#endif
     check_and_init
 
     // 1. Check: config() must have been successful (at least 2 sectors)
     bool success =  (_numSecs < 1) ? 0 : 1;
 
     if (success == 1) {
-	    // --- 2. CHECKING METADATA (Magic ID and Version) ---
+        uint16_t pos = 0;
+        restoreStep(forceFormat, pos, 0xFFFF);
+    }
+
+    return_and_checksum success;
+}
 
-        trans16(_startAddr, &_ioBuf[0]);
-	    trans16(_pldSize, &_ioBuf[2]);
-	    trans16(_numSecs, &_ioBuf[4]);
-	    _ioBuf[6] = _cntLen;
-	    uint8_t c_hash = calculateCRC(_ioBuf, 7);
+// Metadata check, format (if necessary) and head search of the selected partition. The
+// zero-fill of a format runs in slices of at least quota sectors: pos = 1 + next sector to
+// fill (0 = not started). Returns true when the partition is restored. The Magic ID is
+// written after the last slice, so a reset during the zero-fill repeats the format.
+bool EEProm_Safe_Wear_Level::restoreStep(bool forceFormat, uint16_t& pos, uint16_t quota) {
+    uint8_t handle = _handle;
+    _handle1 = 0xFF;
 
-	    // Read Magic ID 
+    if (pos == 0) {
+	    // --- 2. CHECKING METADATA (Magic ID and Version) ---
+	    uint8_t c_hash = layoutHash();
+
+#if EEPRWL_META_RING > 0
+	    uint8_t id[2]; uint16_t ovw;
+	    metaLoad(id, ovw);
+	    uint8_t magicID_read = id[0];
+	    uint8_t c_hash_read = id[1];
+#else
+	    // Read Magic ID (bits 4-6: format epoch)
 	    uint8_t magicID_read = e_r(_startAddr);
 	    // Read Config Hash
 	    uint8_t c_hash_read = e_r(_startAddr+1);
+#endif
+	    uint8_t epoch = (magicID_read ^ MAGIC_ID) >> 4;
+	    bool magicOK = ((magicID_read ^ MAGIC_ID) & 0x0F) == 0 && epoch <= EEPRWL_LAZY_FORMAT;
    
 	    // Check: Magic ID or Parameters incorrect?
-        if (magicID_read != MAGIC_ID) {
-    	    e_w(_startAddr + 2,0x00);
-    		e_w(_startAddr + 3,0x00);
+        if (!magicOK) {
+#if EEPRWL_META_RING == 0
+    	    e_mw(_startAddr + 2,0x00);
+    		e_mw(_startAddr + 3,0x00);
+#endif
             for (uint8_t f = 0; f < 4; f++) { 
 		            _buckPerm[f]=143;
 			}
+#if EEPRWL_TOKEN_BUCKETS > 0
+            if (_handle < EEPRWL_TOKEN_BUCKETS) tokenFill(_handle);
+#endif
             e_c;
 			updateBuckets();
 	    };
-	    if (magicID_read != MAGIC_ID || forceFormat == true || c_hash != c_hash_read) {  
+	    if (!magicOK || forceFormat == true || c_hash != c_hash_read) {  
 	        _status = 4;
 	        // Necessary: First use or version conflict -> Format!
-	        formatInternal(handle);
-		e_w(_startAddr + 0, MAGIC_ID);
-		e_w(_startAddr + 1, c_hash);
-	        e_c;
+	        // Unchanged layout: next epoch, the sectors keep their content (lazy format)
+#if EEPRWL_LAZY_FORMAT > 0
+	        epoch = (magicOK && c_hash == c_hash_read && epoch < EEPRWL_LAZY_FORMAT) ? epoch + 1 : 0;
+#else
+	        // Zero-fill only
+	        epoch = 0;
+#endif
+	        _epoch = epoch;
+	        formatInternal();
+#if EEPRWL_SPARE_SECTORS > 0
+	        // New layout (or no valid metadata): all spares are free. A format keeps the table.
+	        if (!magicOK || c_hash != c_hash_read) {
+	            for (uint8_t x = 0; x < 2 * EEPRWL_SPARE_SECTORS; x++) {
+	                if (e_r(_startAddr + REMAP_ADDR + x) != 0xFF) e_mw(_startAddr + REMAP_ADDR + x, (uint8_t)0xFF);
+	            }
+	            e_c;
+	            _remapHandle = 0xFF;
+	        }
+#endif
 	        _nextPhSec = 0; _curLgcCnt = 0;
+	        // Epoch 0: the sectors are zero-filled first
+	        if (epoch == 0) pos = 1;
 	    }else {
+	        _epoch = epoch;
 	        // --- 4. RESTORATION ---
-	        // If the metadata is valid, find the latest sector.
-	        findMarginalSector(handle,0);
+	        // If the metadata is valid, restore the head from the hint or find the latest sector.
+	        if (!restoreHead()) findMarginalSector(handle,0);
+	        // After findMarginalSector(), the state is set either to the latest sector
+	        // or (if no sector was valid) to counter 0.
+	        return true;
         }
+    }
 
-	    // After findMarginalSector(), the state is set either to the latest sector
-	    // or (if no sector was valid) to counter 0.
+    if (pos > 0) {
+        pos = zeroSectors(pos - 1, quota) + 1;
+        if (pos <= _numSecs) return false;
+        pos = 0;
     }
 
-    return_and_checksum success;
+    uint8_t id[2] = {(uint8_t)(MAGIC_ID ^ (_epoch << 4)), layoutHash()};
+#if EEPRWL_META_RING > 0
+    // One record: new Magic ID and the overwrite counter of this format (new count after an
+    // invalid Magic ID)
+    uint8_t old[2]; uint16_t ovw;
+    uint16_t count = metaLoad(old, ovw);
+    bool counted = ((old[0] ^ MAGIC_ID) & 0x0F) == 0 && (old[0] ^ MAGIC_ID) >> 4 <= EEPRWL_LAZY_FORMAT;
+    metaSave(id, counted ? ovw + 1 : 1, count);
+#else
+    e_mwb(_startAddr, id, 2);
+#endif
+    e_c;
+    return true;
+}
+
+// First access to a partition with deferred restore (config(), EEPRWL_LAZY_INIT): the restore
+// is completed, a zero-fill started by idle() is continued.
+void EEProm_Safe_Wear_Level::restorePending(uint8_t handle) {
+#if EEPRWL_LAZY_INIT > 0
+    _restoring &= ~(1U << handle);
+    uint16_t pos = (handle == _rstHandle) ? _rstPos : 0;
+    restoreStep(false, pos, 0xFFFF);
+    if (handle == _rstHandle) _rstPos = 0;
+#else
+    (void)handle;
+#endif
+}
+
+bool EEProm_Safe_Wear_Level::isRestored(uint8_t handle) {
+#if EEPRWL_LAZY_INIT > 0
+    if (handle < 16 && (_restoring & (1U << handle))) return false;
+#else
+    (void)handle;
+#endif
+    return true;
+}
+
+// Control hash (CRC-8) of the partition layout
+uint8_t EEProm_Safe_Wear_Level::layoutHash() {
+    trans16(_startAddr, &_ioBuf[0]);
+    trans16(_pldSize, &_ioBuf[2]);
+    trans16(_numSecs, &_ioBuf[4]);
+    // Bit 7 (unused by the lengths): sectors with ECC check word
+    _ioBuf[6] = _cntCfg | ((EEPRWL_ECC > 0) ? 0x80 : 0);
+    return (uint8_t)calculateCRC(_ioBuf, 7);
 }
 
 // ----------------------------------------------------------------------------------------------------
 
 uint16_t EEProm_Safe_Wear_Level::getOverwCounter(uint8_t handle) {
     check_and_init
+    uint16_t ovw = overwCounter();
+    return_and_checksum ovw;
+}
 
+// Overwrite counter of the selected partition
+uint16_t EEProm_Safe_Wear_Level::overwCounter() {
+#if EEPRWL_META_RING > 0
+    uint8_t id[2]; uint16_t ovw;
+    metaLoad(id, ovw);
+    return ovw;
+#else
     // We read the 16-bit version from addresses _startAddr + 2 and + 3
     union U16toB {uint16_t u16;uint8_t u8[2];};
     U16toB version_read;
     version_read.u8[0] = e_r(_startAddr + 2);
     version_read.u8[1] = e_r(_startAddr + 3);
-    return_and_checksum version_read.u16; // Returns the correct 16-bit value.
+    return version_read.u16; // Returns the correct 16-bit value.
+#endif
+}
+
+uint16_t EEProm_Safe_Wear_Level::metaWear(uint8_t handle) {
+    check_and_init
+    uint16_t wear;
+#if EEPRWL_META_RING > 0
+    // Every slot is written once per EEPRWL_META_RING records
+    uint8_t id[2]; uint16_t ovw;
+    wear = (uint16_t)((metaLoad(id, ovw) + EEPRWL_META_RING - 1UL) / EEPRWL_META_RING);
+#else
+    // The counter cells are written with every format and rollover
+    wear = overwCounter();
+#endif
+    return_and_checksum wear;
+}
+
+/*
+ * METADATA RING (EEPRWL_META_RING)
+ *
+ * Without the ring, every format and every counter rollover writes the same two cells
+ * (overwrite counter), every format also the Magic ID and the hash; the WLM bucket states
+ * are single cells at the end of the EEPROM. With the ring, Magic ID, hash and overwrite
+ * counter form one record with a 16-bit write count and a CRC, written into slot
+ * (count % EEPRWL_META_RING). The newest valid record counts; a torn record fails its CRC,
+ * the previous one is still valid. Bit 7 of the stored Magic ID is inverted, so a build
+ * without the ring does not accept the ring as fixed cells. The 8 WLM states are a 3-byte
+ * record (states, sequence, CRC) in 3 slots of the WLM area, written only on a change.
+ */
+// Newest record of the selected partition: Magic ID and hash (0xFF: no record) and overwrite
+// counter. Returns the write count of the ring (0: no record).
+uint16_t EEProm_Safe_Wear_Level::metaLoad(uint8_t* id, uint16_t& ovw) {
+    uint16_t count = 0;
+    id[0] = 0xFF; id[1] = 0xFF; ovw = 0;
+#if EEPRWL_META_RING > 0
+    for (uint8_t r = 0; r < EEPRWL_META_RING; r++) {
+        uint8_t rec[META_REC];
+        e_rb(_startAddr + r * META_REC, rec, META_REC);
+        if (rec[6] != (uint8_t)calculateCRC(rec, 6)) continue;
+        uint16_t c = readLE(&rec[4], 2);
+        if (c % EEPRWL_META_RING != r || (count > 0 && (int16_t)(c - count) <= 0)) continue;
+        id[0] = rec[0] ^ 0x80; id[1] = rec[1];
+        ovw = readLE(&rec[2], 2);
+        count = c;
+    }
+#endif
+    return count;
+}
+
+// Writes Magic ID, hash and overwrite counter as the record after write count 'count'
+void EEProm_Safe_Wear_Level::metaSave(const uint8_t* id, uint16_t ovw, uint16_t count) {
+#if EEPRWL_META_RING > 0
+    // Write count 0 marks "no record"
+    if (++count == 0) count = EEPRWL_META_RING;
+    uint8_t rec[META_REC] = {(uint8_t)(id[0] ^ 0x80), id[1]};
+    writeLE(&rec[2], ovw, 2);
+    writeLE(&rec[4], count, 2);
+    rec[6] = (uint8_t)calculateCRC(rec, 6);
+    e_mwb(_startAddr + (count % EEPRWL_META_RING) * META_REC, rec, META_REC);
+#else
+    (void)id; (void)ovw; (void)count;
+#endif
+}
+
+// Writes the WLM bucket states as the next record of the WLM ring
+void EEProm_Safe_Wear_Level::wlmSave(uint8_t states) {
+#if EEPRWL_META_RING > 0
+    _wlmStates = states; _wlmSeq++;
+    uint8_t rec[WLM_REC] = {states, _wlmSeq};
+    rec[2] = (uint8_t)calculateCRC(rec, 2);
+    e_mwb(_bucketStartAddr + (_wlmSeq % (WLM_SIZE / WLM_REC)) * WLM_REC, rec, WLM_REC);
+    e_c;
+#else
+    (void)states;
+#endif
+}
+
+/*
+ * SECTOR RETIREMENT (EEPRWL_SPARE_SECTORS)
+ *
+ * The last EEPRWL_SPARE_SECTORS sectors of a partition are spares outside the ring (physical
+ * sectors _numSecs ..). When a written sector fails its verify, the first free entry of the
+ * remap table (behind the head hints) takes the ring position of the sector and the record
+ * is written again into that spare. sectorAddr() maps a ring position to the spare of its
+ * newest entry, so the head search, the navigation and the counter arithmetic see an
+ * unchanged ring. A failing spare is retired the same way. A format keeps the table (the
+ * cells stay worn), a layout change clears it. With all spares used, a failed write is
+ * reported as before.
+ */
+// Physical sector of a ring sector
+uint16_t EEProm_Safe_Wear_Level::spareOf(uint16_t sector) {
+#if EEPRWL_SPARE_SECTORS > 0
+    if (_remapHandle != _handle) remapLoad();
+    for (uint8_t k = EEPRWL_SPARE_SECTORS; k-- > 0; ) {
+        if (_remap[k] == sector) return _numSecs + k;
+    }
+#endif
+    return sector;
+}
+
+// Remap table of the selected partition into RAM (once per handle switch).
+// Returns the number of used spares.
+uint8_t EEProm_Safe_Wear_Level::remapLoad() {
+    uint8_t n = 0;
+#if EEPRWL_SPARE_SECTORS > 0
+    if (_remapHandle != _handle) {
+        uint8_t buf[2 * EEPRWL_SPARE_SECTORS];
+        e_rb(_startAddr + REMAP_ADDR, buf, sizeof(buf));
+        for (uint8_t k = 0; k < EEPRWL_SPARE_SECTORS; k++) _remap[k] = readLE(&buf[2 * k], 2);
+        _remapHandle = _handle;
+    }
+    for (uint8_t k = 0; k < EEPRWL_SPARE_SECTORS; k++) {
+        if (_remap[k] < _numSecs) n++;
+    }
+#endif
+    return n;
+}
+
+// Maps the ring sector to the next free spare (status 19). Returns false if no spare is left.
+bool EEProm_Safe_Wear_Level::retireSector(uint16_t sector) {
+#if EEPRWL_SPARE_SECTORS > 0
+    remapLoad();
+    for (uint8_t k = 0; k < EEPRWL_SPARE_SECTORS; k++) {
+        if (_remap[k] < _numSecs) continue;
+        uint8_t entry[2];
+        writeLE(entry, sector, 2);
+        e_mwb(_startAddr + REMAP_ADDR + 2 * k, entry, 2);
+        e_c;
+        _remap[k] = sector;
+        _status = 19;
+        return true;
+    }
+#else
+    (void)sector;
+#endif
+    return false;
+}
+
+uint8_t EEProm_Safe_Wear_Level::retiredSectors(uint8_t handle) {
+    check_and_init
+    uint8_t n = remapLoad();
+    return_and_checksum n;
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -265,66 +704,238 @@ void EEProm_Safe_Wear_Level::_read(uint8_t ReadMode, uint8_t handle) {
             break;
         case 3:
             findMarginalSector(handle, 1);
-            cli();
+            irq_relock();
             _handle1 = handle;
             return;
         case 4:
             findMarginalSector(handle, 0);
-            cli();
+            irq_relock();
             _handle1 = handle;
             return;
         default:
             break;
     }
     
+#if EEPRWL_WRITE_BACK > 0
+    // Unsaved value in the write-back slot: it is the current record
+    if (ReadMode == 0 && handle < EEPRWL_WRITE_BACK && (_wbDirty & (1 << handle))) {
+        memcpy(_ioBuf, _wbBuf[handle], _pldSize);
+        _ioBuf[_secSize - 1] = 1;
+        _handle1 = handle;
+        return;
+    }
+#endif
+
     if (_handle1 != handle) {
+        // Newest record in the record cache: RAM copy instead of the EEPROM
+        if (loadNewest(handle)) { _handle1 = handle; return; }
         _checksum = chkSum();
 	loadPhysSector(_nextPhSec, handle);
-        cli();
+        irq_relock();
         _handle1 = handle;
     }
 }
 
 // ----------------------------------------------------------------------------------------------------
 
+// Random access: the ring is strictly sequential, so the sector of a logical counter follows
+// from the current record (counter _curLgcCnt in the sector before _nextPhSec). The record is
+// loaded into _ioBuf; the position of read(1/2) and write() is not changed.
+bool EEProm_Safe_Wear_Level::readCounter(uint32_t cnt, uint8_t handle) {
+    // _ioBuf no longer holds the current record of read(0)
+    _handle1 = 0xFF;
+
+    uint16_t sector;
+    if (cnt > 0 && counterSector(cnt, sector)) return true;
+
+    // Not found: overwritten, not yet written - or the reference itself is not intact
+    // (navigation onto an invalid sector). Then the head is searched once.
+    uint32_t cC;
+    if (cnt > 0 && !(readSector((_nextPhSec == 0) ? _numSecs - 1 : _nextPhSec - 1, cC) == SEC_VALID && cC == _curLgcCnt)) {
+        uint32_t curCnt = _curLgcCnt;
+        uint16_t nextSec = _nextPhSec;
+        bool found = findMarginalSector(handle, 0) && counterSector(cnt, sector);
+        _curLgcCnt = curCnt; _nextPhSec = nextSec;
+        if (found) return true;
+    }
+
+    _ioBuf[_secSize - 1] = 0;
+    _status = 15;
+    return false;
+}
+
+// Reads the sector of logical counter cnt: valid checksum and exactly this counter
+bool EEProm_Safe_Wear_Level::counterSector(uint32_t cnt, uint16_t& sector) {
+    uint16_t cur = (_nextPhSec == 0) ? _numSecs - 1 : _nextPhSec - 1;
+
+    // More than one ring away: cannot be stored
+    uint32_t back = cntDiff(_curLgcCnt, cnt);
+    if (back < _numSecs) sector = (cur + _numSecs - back) % _numSecs;
+    else {
+        uint32_t fwd = cntDiff(cnt, _curLgcCnt);
+        if (fwd >= _numSecs) return false;
+        sector = (cur + fwd) % _numSecs;
+    }
+
+    uint32_t cC;
+    return readSector(sector, cC) == SEC_VALID && cC == cnt;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Blocking migration: all records of the job in one call. Each record is read and written
+// by its own lock section. A record rejected by the write budget of the target ends the call
+// (false), the job stays pending for migrateStep() / idle().
 bool EEProm_Safe_Wear_Level::migrateData(uint8_t sourceHandle, uint8_t targetHandle, uint16_t count) {
 
-    bool success = findMarginalSector(sourceHandle,0); 
-    if (!success) return false;
-    
-    uint16_t count1 = 1;
-    uint16_t sectors = _numSecs - 1;
-    uint16_t actSector = _nextPhSec;
-   
-    // find newest sector at source partition 
-    // migration starts when a sector is found, with searching backward
-
-    while (count > 1 && sectors > 0) {
-	actSector--;
-        success = loadPhysSector(actSector, sourceHandle);
-        actSector = _nextPhSec;
-        if (success == true) { count--; count1++; } 
-        sectors--;
-    }
-
-    // now migrate a sector to target partition
-
-    while (count1 > 0) {
-	uint16_t i = 1;
-	while (write((const char*)_ioBuf,targetHandle) == 0 && i < _numSecs) { i++; }
-        if (i == _numSecs) { count1 = 1; success = 0; }
-	if (count1 > 1) {
-                success = 0;
-	        while (success == 0) {
-		        actSector++;
-		    	success = loadPhysSector(actSector,sourceHandle);
-                        actSector = _nextPhSec;
-	        }
-	}
-	count1--;
+    if (!migrateBegin(sourceHandle, targetHandle, count)) return false;
+
+    uint16_t total = _migLeft, copied = 0, n;
+    while ((n = migrateStep(255)) > 0) copied += n;
+
+    return copied == total;
+}
+
+/*
+ * INCREMENTAL MIGRATION
+ *
+ * migrateBegin() defines the job: the newest count records of the source, oldest first.
+ * migrateStep() copies at most maxRecords of them per call in a single pass: the next record
+ * is read by its logical counter (readCounter(), one sector read) and written to the target
+ * with the target's write budget. A rejected record ends the step and is repeated by the
+ * next one. idle() runs EEPRWL_MIGRATE_STEP records per call while a job is pending.
+ *
+ * Reboot: the job (source counter of the first record, target counter before it) is stored
+ * once at the start (EEPRWL_MIGRATE_JOB). Every record written to the target advances its
+ * logical counter, so the progress follows from the target head after a reboot: no record
+ * is copied twice or skipped. Source records that are overwritten (or corrupt) before their
+ * turn are skipped with status 17; the job is then stored again with the new base.
+ * The target must not be written by the application while the job is pending.
+ */
+bool EEProm_Safe_Wear_Level::migrateBegin(uint8_t sourceHandle, uint8_t targetHandle, uint16_t count) {
+    uint8_t handle = targetHandle;
+    check_and_init
+
+    // Target head: base of the progress
+    findMarginalSector(handle, 0);
+    uint32_t base = _curLgcCnt;
+    uint8_t pldSize = _pldSize;
+    _end();
+
+    handle = sourceHandle;
+    check_and_init
+
+    bool success = (count > 0 && sourceHandle != targetHandle && pldSize == _pldSize && findMarginalSector(handle, 0));
+    if (success) {
+        // At most the records stored in the ring
+        uint16_t stored = (rollover() || _curLgcCnt > _numSecs) ? _numSecs : _curLgcCnt;
+        if (count > stored) count = stored;
+
+        _migSrc = sourceHandle; _migTgt = targetHandle;
+        _migLeft = count;
+        _migNext = cntPrev(_curLgcCnt, count - 1);
+        _migBase = base;
+        _migResume = false;
+        migrateSave(true);
     }
 
-    return success;
+    return_and_checksum success;
+}
+
+// Records of the job not yet copied; a job loaded from the EEPROM first takes the
+// progress from the target head (both partitions configured)
+uint16_t EEProm_Safe_Wear_Level::migratePending() {
+    if (_migLeft > 0 && _migResume) migrateResume();
+    return _migLeft;
+}
+
+// Copies up to maxRecords records of the pending job, returns the records written
+uint16_t EEProm_Safe_Wear_Level::migrateStep(uint8_t maxRecords) {
+    uint16_t copied = 0;
+    uint8_t handle;
+
+    while (_migLeft > 0 && copied < maxRecords) {
+        if (_migResume && !migrateResume()) break;
+
+        // 1. Source record of the next counter (skips lost records)
+        handle = _migSrc;
+        if (!_start(handle)) break;
+        uint16_t lost = 0;
+        while (lost < _migLeft && !readCounter(cntNext(_migNext, lost), handle)) lost++;
+        uint32_t cnt = cntNext(_migNext, lost), next = cntNext(cnt, 1);
+        if (lost > 0) _status = 17;
+        _end();
+
+        // 2. The payload (_ioBuf) as the next record of the target
+        handle = _migTgt;
+        if (!_start(handle)) break;
+        if (lost > 0) {
+            _migLeft -= lost; _migNext = cnt;
+            // New base: the progress is counted from the current target head
+            _migBase = _curLgcCnt;
+            migrateSave(_migLeft > 0);
+            if (_migLeft == 0) { _end(); break; }
+        }
+        bool success = _write(handle);
+        if (success) {
+            _migNext = next; _migLeft--; copied++;
+            if (_migLeft == 0) migrateSave(false);
+        } else if (_status != 8) {
+            // Not a budget limit (e.g. status 3): job ended
+            _migLeft = 0;
+            migrateSave(false);
+        }
+        _end();
+        if (!success) break;
+    }
+
+    return copied;
+}
+
+// Progress of a job loaded from the EEPROM: target records written since _migBase
+bool EEProm_Safe_Wear_Level::migrateResume() {
+    uint8_t handle = _migTgt;
+    check_and_init
+
+    bool success = (_numSecs > 0);
+    uint32_t copied = cntDiff(_curLgcCnt, _migBase);
+    if (copied > _migLeft) {
+        // Target written outside the job: job ended
+        _migLeft = 0;
+        migrateSave(false);
+        success = 0;
+    }
+    _end();
+
+    handle = _migSrc;
+    if (!success || !_start(handle)) return false;
+    success = (_numSecs > 0);
+    if (success) {
+        _migNext = cntNext(_migNext, copied); _migLeft -= copied;
+        if (_migLeft == 0) migrateSave(false);
+        _migResume = false;
+    }
+
+    return_and_checksum success;
+}
+
+// Stores the job (EEPRWL_MIGRATE_JOB), active = false: job ended
+void EEProm_Safe_Wear_Level::migrateSave(bool active) {
+    if (!active) _migLeft = 0;
+#if EEPRWL_MIGRATE_JOB > 0
+    uint16_t addr = _bucketStartAddr - MIGRATE_JOB_SIZE;
+    if (!active) e_mw(addr, 0xFF);
+    else {
+        uint8_t job[MIGRATE_JOB_SIZE];
+        job[0] = _migSrc; job[1] = _migTgt;
+        writeLE(&job[2], _migLeft, 2);
+        writeLE(&job[4], _migNext, 4);
+        writeLE(&job[8], _migBase, 4);
+        job[12] = (uint8_t)calculateCRC(job, 12);
+        e_mwb(addr, job, MIGRATE_JOB_SIZE);
+    }
+    e_c;
+#endif
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -332,7 +943,7 @@ bool EEProm_Safe_Wear_Level::migrateData(uint8_t sourceHandle, uint8_t targetHan
 uint16_t EEProm_Safe_Wear_Level::loadPhysSector(uint16_t physSector, uint8_t handle) {
     check_and_init
 
-    uint16_t success;  uint16_t x; _usedSector = 0;
+    uint16_t success;
 
     if (physSector == 65535) physSector = _numSecs-1; 
     else if (physSector == _numSecs) physSector = 0;
@@ -341,40 +952,31 @@ uint16_t EEProm_Safe_Wear_Level::loadPhysSector(uint16_t physSector, uint8_t han
 
     if (physSector == 65535) physSector = _numSecs-1; 
 
-    physSector *= _secSize;
-    physSector += _startAddr + METADATA_SIZE;
-
-    for (x = 0; x < (_secSize - 1); x++) {
-        _ioBuf[x] = e_r(physSector + x);
-    }
-
-    // Read sector checksum from EEPROM
-    uint8_t crc = e_r(physSector + x);
-
-    // Calculate CRC based on the data read into _ioBuf
-    uint8_t crc1 = calculateCRC(_ioBuf, _secSize - 1);
-
-    if (crc == crc1) {
-        _curLgcCnt = readLE(&_ioBuf[_pldSize], _cntLen);
+    uint32_t cC;
+    if (readSector(physSector, cC) == SEC_VALID) {
+        _curLgcCnt = cC;
         success = 1;
         _status = 1;
         if (_usedSector == 0) _status = 7;
     } else success = 0;
 
+    // RAM-internal status flag of the cache (read() only copies valid data)
+    _ioBuf[_secSize - 1] = success;
+
     return_and_checksum success;
 }
 
 // ----------------------------------------------------------------------------------------------------
 
-bool EEProm_Safe_Wear_Level::write(const char* value, uint8_t handle) {
+bool EEProm_Safe_Wear_Level::write(const char* value, uint8_t handle, bool onlyIfChanged) {
     check_and_init
 
     bool success;
 
     // Consistency check
-    if (_numSecs < 1 || _curLgcCnt > _maxLgcCnt) {
+    if (_numSecs < 1 || counterFull()) {
         success = 0;
-        if(_curLgcCnt > _maxLgcCnt) _status = 3;
+        if(counterFull()) _status = 3;
     } else success = 1;
 
     uint16_t slen = strlen(value);
@@ -388,7 +990,7 @@ bool EEProm_Safe_Wear_Level::write(const char* value, uint8_t handle) {
     	        _ioBuf[i] = 0;
     	    }
     	}
-    	success = _write(handle);
+    	success = _write(handle, onlyIfChanged);
     }
 
     return_and_checksum success;
@@ -396,59 +998,100 @@ bool EEProm_Safe_Wear_Level::write(const char* value, uint8_t handle) {
 
 // ----------------------------------------------------------------------------------------------------
 
-bool EEProm_Safe_Wear_Level::_write(uint8_t handle) {
-    uint16_t c; bool success = 1;
-	
-    if (_curLgcCnt == _maxLgcCnt) {
-    	_status = 3;
-	    _ioBuf[_secSize - 1] = 0;
+bool EEProm_Safe_Wear_Level::writeAsync(const char* value, uint8_t handle) {
+    check_and_init
+
+    bool success;
+
+    // Consistency check, one pending job at a time
+    if (_numSecs < 1 || counterFull() || _asyncState == EEPRWL_ASYNC_BUSY) {
         success = 0;
-    }
+        if (counterFull()) _status = 3;
+        else if (_asyncState == EEPRWL_ASYNC_BUSY) _status = 13;
+    } else success = 1;
 
+    uint16_t slen = strlen(value);
 
     if (success == 1) {
-    	uint8_t bI = handle - ((handle >> 3)<<3); 
-    	if (_buckPerm[bI] > 0 && _budgetCycles[bI] == 0) {
-		    _budgetCycles[bI] = _buckCyc;
-	            _buckPerm[bI]--;	
-                    if (_buckPerm[bI] < 64) _status = 9;
-                    else if (_buckPerm[bI] < 120) _status = 10;
-                    else _status = 11;
+    	if (slen > _pldSize) _status = 2;
+    	for (uint16_t i = 0; i < _pldSize; i++) {
+    	    if (i < slen) {
+    	        _ioBuf[i] = value[i];
+    	    } else {
+    	        _ioBuf[i] = 0;
+    	    }
+    	}
+    	success = _writeAsync(handle);
+    }
 
-	     } else if (_buckPerm[bI] == 0 && _budgetCycles[bI] == 0){ 
-		    success = 0; 
-                    _status = 8;
-	     }
-        if(_budgetCycles[bI] > 0) _budgetCycles[bI]--;
+    return_and_checksum success;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+bool EEProm_Safe_Wear_Level::_write(uint8_t handle, bool onlyIfChanged) {
+#if EEPRWL_WRITE_BACK > 0
+    // Write-back mode: only the RAM slot is updated
+    if (handle < EEPRWL_WRITE_BACK && (_wbMode & (1 << handle))) return deferRecord(handle, onlyIfChanged);
+#endif
+
+    // Skip-unchanged mode: the staged payload equals the newest record (RAM copy),
+    // no sector is consumed and the write budget is not charged.
+    if (onlyIfChanged && unchangedRecord(handle)) {
+        _status = 12; _handle1 = handle;
+        _ioBuf[_secSize - 1] = 1;
+        return 1;
     }
 
+    return writeRecord(handle);
+}
+
+// ----------------------------------------------------------------------------------------------------
 
-    if (success == 1) {
-    	_curLgcCnt += 1; _handle1 = handle;
+// The staged payload in _ioBuf equals the newest record of the partition (RAM copies only)
+bool EEProm_Safe_Wear_Level::unchangedRecord(uint8_t handle) {
+    if (_lastHandle == handle && memcmp(_ioBuf, _lastBuf, _pldSize) == 0) return true;
+#if EEPRWL_RECORD_CACHE > 0
+    if (handle < EEPRWL_RECORD_CACHE && _recCnt[handle] != 0 && memcmp(_ioBuf, _recBuf[handle], _pldSize) == 0) return true;
+#endif
+    return false;
+}
 
-		writeLE(&_ioBuf[_pldSize], _curLgcCnt, _cntLen);
+// ----------------------------------------------------------------------------------------------------
 
-    	_ioBuf[_secSize - 1] = calculateCRC(_ioBuf, _secSize - 1);
+// Writes the staged payload in _ioBuf as the next sector (counter, checksum, verify, hint)
+bool EEProm_Safe_Wear_Level::writeRecord(uint8_t handle) {
+    bool success = stageRecord(handle);
 
-    	// Write data
-    	uint32_t Adress = _startAddr + METADATA_SIZE + (_nextPhSec * _secSize);
-    	for (uint16_t x = 0; x < _secSize; x++) {
-    	    e_w(Adress + x, _ioBuf[x]);
-    	}
+    if (success == 1) {
+    	// Write data (one block transfer)
+    	uint16_t Adress = sectorAddr(_nextPhSec);
+    	e_wb(Adress, _ioBuf, _secSize);
     	e_c;
 
     	uint16_t sek = _nextPhSec; _nextPhSec += 1;
     	if (_nextPhSec >= _numSecs) _nextPhSec = 0;
     	
-    	// Compare data
-    	Adress = _startAddr + METADATA_SIZE + (sek * _secSize);
-    	for (c = 0; c < _secSize; c++) {
-    	    uint8_t buf = e_r(Adress + c);
-    	    if (buf != _ioBuf[c]) {
-    	        success = false;
-    	        break;
-    	    }
+    	// Compare data: read back into _lastBuf (replaced by this record anyway)
+    	e_rb(Adress, _lastBuf, _secSize);
+    	if (memcmp(_lastBuf, _ioBuf, _secSize) != 0) success = false;
+#if EEPRWL_SPARE_SECTORS > 0
+    	// Failing sector: retired, the record is written again into its spare
+    	while (success == 0 && retireSector(sek)) {
+    	    Adress = sectorAddr(sek);
+    	    e_wb(Adress, _ioBuf, _secSize);
+    	    e_c;
+    	    e_rb(Adress, _lastBuf, _secSize);
+    	    success = (memcmp(_lastBuf, _ioBuf, _secSize) == 0);
     	}
+#endif
+
+    	// Every _hintInt records: persist the head position (rotating hint slot)
+    	if (success == 1 && _hintInt > 0 && (_curLgcCnt % _hintInt) == 0) writeHint(sek);
+
+    	// The written record is the newest one (or the newest one is unknown after a failure)
+    	if (success == 1) { cacheNewest(); countCommitted(handle, 1); }
+    	else dropNewest(handle);
     }
 	
     _ioBuf[_secSize - 1] = success;
@@ -456,132 +1099,1163 @@ bool EEProm_Safe_Wear_Level::_write(uint8_t handle) {
 }
 
 // ----------------------------------------------------------------------------------------------------
-// --- GETTERS FOR STATE AND METADATA ---
-// Remaining cycles
-uint32_t EEProm_Safe_Wear_Level::healthCycles(uint8_t handle) {
-    check_and_init
 
-    uint32_t success = 1;
-    if (_curLgcCnt >= _maxLgcCnt) {_status = 3; success = 0;}
-    if(success==1) success = _maxLgcCnt - _curLgcCnt;
-    return_and_checksum success;
+// Next logical counter. At the rollover (_maxLgcCnt -> 1) the overwrite counter is
+// incremented first: healthPercent() counts the completed counter range.
+void EEProm_Safe_Wear_Level::nextCounter() {
+    if (_curLgcCnt >= _maxLgcCnt) {
+        bumpOverwCounter();
+        e_c;
+        _curLgcCnt = 1;
+    } else _curLgcCnt += 1;
 }
 
-// Remaining cycles in percent
-uint8_t EEProm_Safe_Wear_Level::healthPercent(uint32_t cycles, uint8_t handle) {
-    check_and_init
-
-    #define _cycles_ cycles/1000
-    // 1. Calculate the absolute total lifetime (TL) (100% limit)
-    // TL = Endurance per sector (_cycles_) * Total number of sectors (_numSecs)
-    #define totalLifetime (uint32_t)_numSecs * _cycles_
-    // 2. Calculate Consumed Cycles (CC) (current wear)
-    // CC = (Overwrite Counter * Max Logical Counter) + Current Logical Counter
-    #define consumedCycles (((uint32_t)getOverwCounter(handle) * _maxLgcCnt)+_curLgcCnt) / 1000UL
-
-    // (Remaining Cycles * 100) / Total Life
-    return_and_checksum (uint8_t)(( (totalLifetime) - (consumedCycles) ) * 100UL) / (totalLifetime);
+// Overwrite counter +1 (format or counter rollover)
+void EEProm_Safe_Wear_Level::bumpOverwCounter() {
+#if EEPRWL_META_RING > 0
+    uint8_t id[2]; uint16_t ovw;
+    uint16_t count = metaLoad(id, ovw);
+    metaSave(id, ovw + 1, count);
+#else
+    union U16toB {uint16_t u16;uint8_t u8[2];}; 
+    U16toB __EEPRWL_VER; __EEPRWL_VER.u16 = _EEPRWL_VER; 
+    __EEPRWL_VER.u8[0] = e_r(_startAddr + 2);
+    __EEPRWL_VER.u8[1] = e_r(_startAddr + 3);
+    __EEPRWL_VER.u16++;
+    e_mwb(_startAddr + 2, __EEPRWL_VER.u8, 2);
+#endif
 }
 
 // ----------------------------------------------------------------------------------------------------
-// internal time management
-
-void EEProm_Safe_Wear_Level::oneTickPassed() {
-    _tbCntN--; 
 
-    if(_tbCntN == 0) {
-    	_tbCntN = _tbCnt;
+// Counter limit and write budget (WLM) check, then the logical counter and the
+// checksum are added to the payload in _ioBuf. Shared by write() and writeAsync().
+bool EEProm_Safe_Wear_Level::stageRecord(uint8_t handle) {
+    bool success = 1;
 
-		if (_tbCntLong < 3600) updateBuckets();
-    	else _accumulatedTime += _tbCntLong;
-        	
-		while (_accumulatedTime > 3599) {
-       		_accumulatedTime -= 3600;
-			updateBuckets();
-		}
+    if (counterFull()) {
+    	_status = 3;
+	    _ioBuf[_secSize - 1] = 0;
+        success = 0;
     }
 
-}
 
-void EEProm_Safe_Wear_Level::idle() {
-    #define lastTime  (uint16_t)(millis() / 60000)
+#if EEPRWL_WRITE_BACK > 0
+    // Power-fail flush: the last values are written regardless of the write budget
+    bool budget = !_wbForce;
+#else
+    const bool budget = true;
+#endif
+    if (success == 1 && budget && budgetDebit(handle, 1) == 0) success = 0;
 
-    if ((lastTime - _buckTime) > 60) {
-         _buckTime = lastTime;
-         updateBuckets();
+
+    if (success == 1) {
+    	nextCounter(); _handle1 = handle;
+
+		writeLE(&_ioBuf[_pldSize], _curLgcCnt, _cntLen);
+		if (_tsLen > 0) writeLE(&_ioBuf[_pldSize + _cntLen], clockTime(), _tsLen);
+
+    	sealSector();
     }
 
+    return success;
 }
 
 // ----------------------------------------------------------------------------------------------------
 
-uint8_t EEProm_Safe_Wear_Level::getWrtAccBalance(uint8_t handle) {
-    return _buckPerm[handle>>5];
-}
+// Charges count writes to the write budget (WLM) of the partition, with the same result
+// as count single debits. Returns the number of writes covered by the budget.
+uint16_t EEProm_Safe_Wear_Level::budgetDebit(uint8_t handle, uint16_t count) {
+#if EEPRWL_PRIORITY_POOL > 0
+    uint8_t prio = priority(handle);
+    uint16_t n = 0;
+
+    // Low priority: the last quarter of the budget is left to the other classes
+    if (prio != EEPRWL_PRIO_LOW || getWrtAccBalance(handle) >= 64) n = budgetCredit(handle, count);
+    else _status = 8;
+
+    // Critical: the rest is borrowed from the reserve pool
+    if (prio == EEPRWL_PRIO_CRITICAL && n < count && _prioPool > 0) {
+        uint16_t b = (count - n < _prioPool) ? count - n : _prioPool;
+        _prioPool -= b;
+        n += b;
+        _status = (n < count) ? 8 : 18;
+    }
 
-// ----------------------------------------------------------------------------------------------------
-bool EEProm_Safe_Wear_Level::findNewestData(uint8_t handle) {
-    check_and_init
-    bool success = findMarginalSector(handle, 0);
-    return_and_checksum success;
-}
-// ----------------------------------------------------------------------------------------------------
-bool EEProm_Safe_Wear_Level::findOldestData(uint8_t handle) {
-    check_and_init
-    bool success = findMarginalSector(handle, 1);
-    return_and_checksum success;
+    _prioShed[prio] += count - n;
+    return n;
+#else
+    return budgetCredit(handle, count);
+#endif
 }
-// ----------------------------------------------------------------------------------------------------
-// --- PRIVATE HELPER ---
-// ----------------------------------------------------------------------------------------------------
-
-void EEProm_Safe_Wear_Level::updateBuckets() {
 
-  for (uint8_t i = 0; i < 8; i++) { 
-       if (_buckPerm[i] < 255) _buckPerm[i]++;
-       uint8_t value = e_r(_bucketStartAddr+i);
-       uint8_t stat = (_buckPerm[i] < 62) ? 0 : (_buckPerm[i] > 64) ? 127: value;
-       if (value != stat ) {
-               e_w(_bucketStartAddr+i, stat);
-               e_c;
-       }
-  }
+// Debit of the token bucket or the shared credit bucket of the partition
+uint16_t EEProm_Safe_Wear_Level::budgetCredit(uint8_t handle, uint16_t count) {
+#if EEPRWL_TOKEN_BUCKETS > 0
+    if (handle < EEPRWL_TOKEN_BUCKETS) return tokenDebit(handle, count);
+#endif
+    uint8_t bI = handle & 7;
+    uint8_t per = (_buckCyc > 0) ? _buckCyc : 1;   // writes per credit
+    uint32_t avail = _budgetCycles[bI] + (uint32_t)_buckPerm[bI] * per;
+    uint16_t n = (count > avail) ? avail : count;
+
+    if (n <= _budgetCycles[bI]) _budgetCycles[bI] -= n;
+    else {
+        // Credits taken from the bucket
+        uint16_t rest = n - _budgetCycles[bI];
+        uint8_t credits = (rest + per - 1) / per;
+
+        _buckPerm[bI] -= credits;
+        _budgetCycles[bI] = (_buckCyc > 0) ? credits * per - rest : 0;
+        if (_buckPerm[bI] < 64) _status = 9;
+        else if (_buckPerm[bI] < 120) _status = 10;
+        else _status = 11;
+    }
 
+    // Write shedding
+    if (n < count) _status = 8;
+    return n;
 }
 
 // ----------------------------------------------------------------------------------------------------
 
-bool EEProm_Safe_Wear_Level::findMarginalSector(uint8_t handle, uint8_t margin) {
-    _curLgcCnt = margin > 0 ? (-1) : 0; _nextPhSec = 0;  bool success = false;
+// Writes up to count records (stride size bytes) into consecutive sectors: one budget
+// debit, one sector transfer per record, then one verify pass over the whole batch.
+// Returns the number of committed (written and verified) records; the head stands
+// at the last of them.
+uint16_t EEProm_Safe_Wear_Level::_writeBatch(const uint8_t* data, uint16_t size, uint16_t count, uint8_t handle) {
+    uint16_t len = (size < _pldSize) ? size : _pldSize;
+    uint16_t n, i;
+
+    if (size > _pldSize) _status = 2;
+
+    // The batch must not overwrite itself or exceed the logical counter
+    if (count > _numSecs) count = _numSecs;
+    if (!rollover() && count > _maxLgcCnt - _curLgcCnt) { count = _maxLgcCnt - _curLgcCnt; _status = 3; }
+    n = (count > 0) ? budgetDebit(handle, count) : 0;
+
+    uint32_t c0 = _curLgcCnt;
+    uint16_t s0 = _nextPhSec;
+    uint32_t now = clockTime();
+    _handle1 = handle;
+#if EEPRWL_WRITE_BACK > 0
+    // The batch is newer than an unsaved write-back value
+    if (n > 0 && handle < EEPRWL_WRITE_BACK) _wbDirty &= ~(1 << handle);
+#endif
+
+    for (i = 0; i < n; i++) {
+    	nextCounter();
+    	batchImage(data + (size_t)i * size, len, _curLgcCnt, now);
+
+    	e_wb(sectorAddr(_nextPhSec), _ioBuf, _secSize);
+    	e_c;
 
-    // Search all sectors
-    // i MUST be uint16_t to support > 255 sectors (e.g., with 2KB EEPROM)
-    for (uint16_t i = 0; i < _numSecs; i++) {
-        uint32_t cC = 0;
-        uint8_t crc, crc1, x, c;
-        uint32_t Address = _startAddr + METADATA_SIZE + (i * _secSize);
+    	_nextPhSec += 1;
+    	if (_nextPhSec >= _numSecs) _nextPhSec = 0;
+#if EEPRWL_LOCK == EEPRWL_LOCK_FULL
+    	// Interrupts are served between the sectors of the batch
+    	_end();
+    	irq_off();
+#endif
+    }
 
-        // --- 1. Read sector into _ioBuf and check CRC ---
+    // Verify pass: sector valid, expected counter and payload
+    uint16_t sek = s0;
+    for (i = 0; i < n; i++) {
+    	if (!batchVerify(sek, data + (size_t)i * size, len, cntNext(c0, i + 1), now)) break;
+    	if (++sek >= _numSecs) sek = 0;
+    }
 
-        // Read data bytes and sector counter. The loop condition MUST be
-        // (_secSize - 1) because the last uint8_t (CRC) is read separately.
-        for (x = 0; x < (_secSize - 1); x++) {
-            _ioBuf[x] = e_r(Address + x);
-        }
+    // Failed sector: the head goes back to the last verified record, the failed sector and
+    // the records behind it are zero-filled, so readers and a restart see the committed ones only
+    if (i < n) {
+    	_curLgcCnt = cntNext(c0, i);
+    	_nextPhSec = sek;
+    	_handle1 = 0xFF;   // _ioBuf no longer holds the newest record
+    	memset(_ioBuf, 0x00, _secSize - CRC_LEN);
+    	memset(_ioBuf + _secSize - CRC_LEN, 0xF0, CRC_LEN);
+    	for (uint16_t k = i; k < n; k++) {
+    	    e_wb(sectorAddr(sek), _ioBuf, _secSize);
+    	    e_c;
+    	    if (++sek >= _numSecs) sek = 0;
+    	}
+    }
+
+    // Head hints of the committed records
+    if (_hintInt > 0) {
+    	for (uint16_t k = 1; k <= i; k++) {
+    	    uint32_t c = cntNext(c0, k);
+    	    if (c % _hintInt != 0) continue;
+    	    uint8_t slot[3];
+    	    e_mwb(hintSlot((s0 + k - 1) % _numSecs, slot, c), slot, 3);
+    	}
+    	e_c;
+    }
+
+    // The last record is the newest one (or the newest one is unknown after a failure)
+    if (n > 0 && i == n) cacheNewest();
+    else dropNewest(handle);
+    countCommitted(handle, i);
+
+    _ioBuf[_secSize - 1] = (n > 0 && i == n);
+    return i;
+}
+
+// Sector image of a batch record in _ioBuf: payload (zero-padded), counter, timestamp, checksum
+void EEProm_Safe_Wear_Level::batchImage(const uint8_t* rec, uint16_t len, uint32_t cnt, uint32_t now) {
+    memcpy(_ioBuf, rec, len);
+    memset(_ioBuf + len, 0, _pldSize - len);
+
+    writeLE(&_ioBuf[_pldSize], cnt, _cntLen);
+    if (_tsLen > 0) writeLE(&_ioBuf[_pldSize + _cntLen], now, _tsLen);
+    sealSector();
+}
+
+// Verify of a batch record: sector valid, expected counter and payload. A failing sector is
+// retired (EEPRWL_SPARE_SECTORS) and the record is written again into its spare.
+bool EEProm_Safe_Wear_Level::batchVerify(uint16_t sector, const uint8_t* rec, uint16_t len, uint32_t cnt, uint32_t now) {
+    uint32_t c;
+    bool ok = readSector(sector, c) == SEC_VALID && c == cnt
+           && memcmp(_ioBuf, rec, len) == 0 && !usedBytes(_ioBuf + len, _pldSize - len);
+#if EEPRWL_SPARE_SECTORS > 0
+    while (!ok && retireSector(sector)) {
+        batchImage(rec, len, cnt, now);
+        e_wb(sectorAddr(sector), _ioBuf, _secSize);
+        e_c;
+        ok = readSector(sector, c) == SEC_VALID && c == cnt
+          && memcmp(_ioBuf, rec, len) == 0 && !usedBytes(_ioBuf + len, _pldSize - len);
+    }
+#else
+    (void)now;
+#endif
+    return ok;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Stages the record in _ioBuf as an asynchronous job: the sector image, its address
+// and (if due) the head hint are copied, so the job needs no partition context.
+bool EEProm_Safe_Wear_Level::_writeAsync(uint8_t handle) {
+    if (_asyncBufSize < _secSize) {
+        delete[] _asyncBuf;
+        _asyncBuf = new uint8_t [_secSize];
+        _asyncBufSize = _secSize;
+    }
+
+    bool success = stageRecord(handle);
+
+    if (success == 1) {
+        memcpy(_asyncBuf, _ioBuf, _secSize);
+        _asyncAddr = sectorAddr(_nextPhSec);
+        _asyncLen = _secSize;
+        _asyncPos = 0;
+
+        // Head hint of this record (written after a successful verify)
+        _asyncHintAddr = 0;
+        if (_hintInt > 0 && (_curLgcCnt % _hintInt) == 0) _asyncHintAddr = hintSlot(_nextPhSec, _asyncHint, _curLgcCnt);
+
+        // The sector is reserved now, following writes use the next one
+        _nextPhSec += 1;
+        if (_nextPhSec >= _numSecs) _nextPhSec = 0;
+
+        // The newest record is not readable until the job is verified
+        dropNewest(handle);
+#if EEPRWL_WRITE_BACK > 0
+        // The job is newer than an unsaved write-back value
+        if (handle < EEPRWL_WRITE_BACK) _wbDirty &= ~(1 << handle);
+#endif
+
+        _asyncHandle = handle;
+        _asyncPhase = ASYNC_SECTOR;
+        _asyncState = EEPRWL_ASYNC_BUSY;
+#if defined(EEPRWL_ASYNC_ISR) && defined(ARDUINO)
+        // Only the internal EEPROM has a ready interrupt
+        if (_io == &EEPRWL_internalEEPROM) {
+            EEPRWL_asyncOwner = this;
+            _io->readyInterrupt(true);
+        }
+#endif
+    }
+
+    _ioBuf[_secSize - 1] = success;
+    return success;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// One step of the asynchronous write engine. Every call writes at most one byte and
+// only if the storage is ready, so it never waits for a write cycle.
+// Called from loop() (polling) or from the EEPROM-ready interrupt (EEPRWL_ASYNC_ISR).
+uint8_t EEProm_Safe_Wear_Level::asyncStep() {
+    if (_asyncState != EEPRWL_ASYNC_BUSY || !_io->ready()) return _asyncState;
+
+    switch (_asyncPhase) {
+        case ASYNC_SECTOR:
+            e_w(_asyncAddr + _asyncPos, _asyncBuf[_asyncPos]);
+            if (++_asyncPos >= _asyncLen) _asyncPhase = ASYNC_VERIFY;
+            break;
+
+        case ASYNC_VERIFY:
+            // Last write cycle finished: compare data
+            e_c;
+            for (_asyncPos = 0; _asyncPos < _asyncLen; _asyncPos++) {
+                if (e_r(_asyncAddr + _asyncPos) != _asyncBuf[_asyncPos]) break;
+            }
+            if (_asyncPos < _asyncLen) { asyncFinish(EEPRWL_ASYNC_FAILED); break; }
+
+            _asyncPos = 0;
+            if (_asyncHintAddr > 0) _asyncPhase = ASYNC_HINT;
+            else asyncFinish(EEPRWL_ASYNC_DONE);
+            break;
+
+        case ASYNC_HINT:
+            e_mw(_asyncHintAddr + _asyncPos, _asyncHint[_asyncPos]);
+            if (++_asyncPos >= 3) _asyncPhase = ASYNC_END;
+            break;
+
+        default:
+            // Write cycle of the last hint byte finished
+            e_c;
+            asyncFinish(EEPRWL_ASYNC_DONE);
+    }
+
+    return _asyncState;
+}
+
+void EEProm_Safe_Wear_Level::asyncFinish(uint8_t result) {
+    // read(0) must not return the staged record from the I/O buffer
+    if (result == EEPRWL_ASYNC_FAILED && _handle1 == _asyncHandle) _handle1 = 0xFF;
+    if (result == EEPRWL_ASYNC_DONE) countCommitted(_asyncHandle, 1);
+    _asyncState = result;
+#if defined(EEPRWL_ASYNC_ISR)
+    _io->readyInterrupt(false);
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------------
+// --- GETTERS FOR STATE AND METADATA ---
+// Remaining cycles
+uint32_t EEProm_Safe_Wear_Level::healthCycles(uint8_t handle) {
+    check_and_init
+
+    uint32_t success = 1;
+    if (counterFull()) {_status = 3; success = 0;}
+    // With rollover: records up to the next rollover
+    if(success==1) success = _maxLgcCnt - _curLgcCnt;
+    return_and_checksum success;
+}
+
+// Remaining cycles in percent
+uint8_t EEProm_Safe_Wear_Level::healthPercent(uint32_t cycles, uint8_t handle) {
+    check_and_init
+
+    #define _cycles_ cycles/1000
+    // 1. Calculate the absolute total lifetime (TL) (100% limit)
+    // TL = Endurance per sector (_cycles_) * Total number of sectors (_numSecs)
+    #define totalLifetime (uint32_t)_numSecs * _cycles_
+    // 2. Calculate Consumed Cycles (CC) (current wear)
+    // CC = (Overwrite Counter * Max Logical Counter) + Current Logical Counter
+    #define consumedCycles (((uint32_t)getOverwCounter(handle) * _maxLgcCnt)+_curLgcCnt) / 1000UL
+
+    // (Remaining Cycles * 100) / Total Life
+    return_and_checksum (uint8_t)(( (totalLifetime) - (consumedCycles) ) * 100UL) / (totalLifetime);
+}
+
+// ----------------------------------------------------------------------------------------------------
+// internal time management
+
+void EEProm_Safe_Wear_Level::oneTickPassed() {
+    // No EEPROM access here (may be called from an interrupt): idle() does the deferred work
+    _ticked = true;
+#if EEPRWL_TOKEN_BUCKETS > 0
+    // Token bucket clock, the seconds of an incomplete step are kept
+    _tkRest += _tbCntLong;
+    if (_tkRest >= TOKEN_STEP) { _tkClock += _tkRest / TOKEN_STEP; _tkRest %= TOKEN_STEP; }
+#endif
+    _tbCntN--; 
+
+    if(_tbCntN == 0) {
+    	_tbCntN = _tbCnt;
+
+		if (_tbCntLong < 3600) updateBuckets();
+    	else _accumulatedTime += _tbCntLong;
+        	
+		while (_accumulatedTime > 3599) {
+       		_accumulatedTime -= 3600;
+			updateBuckets();
+		}
+    }
+}
+
+void EEProm_Safe_Wear_Level::idle() {
+    #define lastTime  (uint16_t)(millis() / 60000)
+
+    // With oneTickPassed() as time base idle() only does the deferred work
+#if EEPRWL_TOKEN_BUCKETS > 0
+    uint32_t ms = millis();
+    if (!_ticked) _tkRest += ms - _tkMillis;
+    _tkMillis = ms;
+    if (_tkRest >= TOKEN_STEP * 1000UL) { _tkClock += _tkRest / (TOKEN_STEP * 1000UL); _tkRest %= TOKEN_STEP * 1000UL; }
+#endif
+
+    if (!_ticked && (lastTime - _buckTime) > 60) {
+         _buckTime = lastTime;
+         updateBuckets();
+    }
+
+#if EEPRWL_LAZY_INIT > 0
+    // Deferred restore: one slice of the first restoring partition
+    if (_restoring) {
+        uint8_t handle = 0;
+        while (!(_restoring & (1U << handle))) handle++;
+        if (handle != _rstHandle) { _rstHandle = handle; _rstPos = 0; }
+
+        // _start() must not complete the restore
+        _restoring &= ~(1U << handle);
+        if (_start(handle)) {
+            if (!restoreStep(false, _rstPos, EEPRWL_LAZY_INIT)) _restoring |= (1U << handle);
+            _end();
+        }
+        return;
+    }
+#endif
+
+    // Pending migration: a few records per call
+    if (_migLeft > 0) migrateStep(EEPRWL_MIGRATE_STEP);
+
+#if EEPRWL_WRITE_BACK > 0
+    // Write-back: values unsaved for EEPRWL_WRITE_BACK_MS are written
+    for (uint8_t h = 0; h < EEPRWL_WRITE_BACK; h++) {
+        if ((_wbDirty & (1 << h)) && millis() - _wbTime[h] >= EEPRWL_WRITE_BACK_MS) flush(h);
+    }
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+/*
+ * DELTA ENCODING
+ *
+ * With setDelta() write() stores a record of up to EEPRWL_DELTA_SIZE bytes, larger than the
+ * payload P of the partition, in two forms (first payload byte):
+ *  - Keyframe: the record in n = size / (P - 1) consecutive sectors, DELTA_KEY | chunk index.
+ *  - Delta: 0, then runs [offset, length, bytes] of the bytes changed since the previous
+ *    record (gaps of up to 2 unchanged bytes are part of a run), in one sector.
+ * A keyframe is written every keyframeEvery records, when the runs do not fit into one
+ * sector, after a failed write, and when the keyframe would leave the ring. read(0, ...)
+ * searches back from the newest record for the newest complete keyframe and applies the
+ * deltas behind it. Chunks of an incomplete keyframe (reset or budget) are skipped: the
+ * deltas always refer to the last record written successfully. The other read functions
+ * return the encoded sectors.
+ */
+bool EEProm_Safe_Wear_Level::setDelta(bool enable, uint8_t keyframeEvery, uint8_t handle) {
+    check_and_init
+    bool success = 0;
+#if EEPRWL_DELTA > 0
+    if (handle < EEPRWL_DELTA && _pldSize >= 2) {
+        success = 1;
+        if (enable) _dtMode |= (1 << handle);
+        else _dtMode &= ~(1 << handle);
+        // The reference record is rebuilt by the next write()
+        _dtKnown &= ~(1 << handle);
+        _dtEvery[handle] = (keyframeEvery > 0) ? keyframeEvery : 1;
+    }
+#else
+    (void)enable; (void)keyframeEvery;
+#endif
+    return_and_checksum success;
+}
+
+bool EEProm_Safe_Wear_Level::_writeDelta(const uint8_t* rec, uint16_t size, uint8_t handle, bool onlyIfChanged) {
+#if EEPRWL_DELTA > 0
+    uint8_t d = _pldSize - 1;                 // record bytes per keyframe sector
+    uint16_t chunks = (size + d - 1) / d;
+    uint8_t* ref = _dtBuf[handle];
+    uint8_t bit = 1 << handle;
+
+    if (size > EEPRWL_DELTA_SIZE || chunks > 128 || chunks > _numSecs) { _status = 2; return 0; }
+
+    // Reference record after a start, setDelta() or a size change: rebuilt from the EEPROM
+    if (!(_dtKnown & bit) || _dtSize[handle] != size) {
+        _dtCount[handle] = deltaRebuild(ref, size, handle);
+        if (_dtCount[handle] != 0xFFFF) { _dtKnown |= bit; _dtSize[handle] = size; }
+    }
+    bool known = (_dtKnown & bit) != 0;
+
+    if (onlyIfChanged && known && memcmp(rec, ref, size) == 0) {
+        _status = 12;
+        return 1;
+    }
+
+    // Delta: the keyframe and all deltas behind it must stay in the ring
+    bool key = !known || _dtCount[handle] + 1 >= _dtEvery[handle] || chunks + _dtCount[handle] + 1 > _numSecs;
+    if (!key) {
+        uint16_t pos = 1, i = 0;
+        _ioBuf[0] = 0;
+        while (i < size) {
+            if (rec[i] == ref[i]) { i++; continue; }
+            uint16_t e = i + 1, g = i + 1;
+            while (g < size && g - e < 3) { if (rec[g] != ref[g]) e = g + 1; g++; }
+            // Runs do not fit: keyframe
+            if (pos + 2 + (e - i) > _pldSize) { key = true; break; }
+            _ioBuf[pos++] = i;
+            _ioBuf[pos++] = e - i;
+            memcpy(&_ioBuf[pos], &rec[i], e - i);
+            pos += e - i;
+            i = e;
+        }
+        memset(&_ioBuf[pos], 0, _pldSize - pos);
+    }
+
+    bool success = 1;
+    if (key) {
+        // The keyframe is complete after its last chunk; until then the reference is unknown
+        _dtKnown &= ~bit;
+        for (uint16_t c = 0; c < chunks && success; c++) {
+            uint16_t len = (size - c * d < d) ? size - c * d : d;
+            _ioBuf[0] = DELTA_KEY | c;
+            memcpy(&_ioBuf[1], &rec[c * d], len);
+            memset(&_ioBuf[1 + len], 0, d - len);
+            success = writeRecord(handle);
+        }
+        _dtCount[handle] = 0;
+    } else {
+        success = writeRecord(handle);
+        _dtCount[handle]++;
+    }
+
+    // A failed write: the next record is a keyframe
+    if (success) { memcpy(ref, rec, size); _dtKnown |= bit; _dtSize[handle] = size; }
+    else _dtKnown &= ~bit;
+    return success;
+#else
+    (void)rec; (void)size; (void)handle; (void)onlyIfChanged;
+    return 0;
+#endif
+}
+
+// Newest record of a delta partition into rec (status 15: no complete keyframe)
+bool EEProm_Safe_Wear_Level::_readDelta(uint8_t* rec, uint16_t size, uint8_t handle) {
+#if EEPRWL_DELTA > 0
+    uint8_t bit = 1 << handle;
+
+    // The reference record of the writer is the newest record
+    if ((_dtKnown & bit) && _dtSize[handle] == size) {
+        memcpy(rec, _dtBuf[handle], size);
+        return 1;
+    }
+    if (size <= EEPRWL_DELTA_SIZE) {
+        uint16_t count = deltaRebuild(_dtBuf[handle], size, handle);
+        if (count != 0xFFFF) {
+            _dtCount[handle] = count; _dtSize[handle] = size; _dtKnown |= bit;
+            memcpy(rec, _dtBuf[handle], size);
+            return 1;
+        }
+        _dtKnown &= ~bit;
+    }
+    _status = 15;
+#else
+    (void)rec; (void)size; (void)handle;
+#endif
+    return 0;
+}
+
+// Rebuilds the newest record from the newest complete keyframe and the deltas behind it.
+// Returns the number of records behind the keyframe (0xFFFF: no complete keyframe in the
+// ring, or a missing sector).
+uint16_t EEProm_Safe_Wear_Level::deltaRebuild(uint8_t* rec, uint16_t size, uint8_t handle) {
+#if EEPRWL_DELTA > 0
+    uint8_t d = _pldSize - 1;
+    uint16_t chunks = (size + d - 1) / d;
+    uint16_t back, j;
+
+    if (_curLgcCnt == 0 || size > 255 || chunks > 128) return 0xFFFF;
+
+    // 1. Newest complete keyframe: chunks 0 .. n-1 with consecutive counters
+    for (back = 0; back + chunks <= _numSecs; back++) {
+        uint32_t c = cntPrev(_curLgcCnt, back);
+        if (!readCounter(c, handle)) return 0xFFFF;
+        if (_ioBuf[0] != (DELTA_KEY | (chunks - 1))) continue;
+        for (j = 1; j < chunks; j++) {
+            if (!readCounter(cntPrev(c, j), handle) || _ioBuf[0] != (DELTA_KEY | (chunks - 1 - j))) break;
+        }
+        if (j == chunks) break;
+    }
+    if (back + chunks > _numSecs) return 0xFFFF;
+
+    // 2. Keyframe, then the deltas (chunks of incomplete keyframes are skipped)
+    uint32_t first = cntPrev(_curLgcCnt, back + chunks - 1);
+    for (j = 0; j < chunks; j++) {
+        if (!readCounter(cntNext(first, j), handle)) return 0xFFFF;
+        memcpy(&rec[j * d], &_ioBuf[1], (size - j * d < d) ? size - j * d : d);
+    }
+    for (j = back; j-- > 0; ) {
+        if (!readCounter(cntPrev(_curLgcCnt, j), handle)) return 0xFFFF;
+        if (_ioBuf[0] & DELTA_KEY) continue;
+        for (uint16_t pos = 1; pos + 2 <= _pldSize && _ioBuf[pos + 1] > 0; ) {
+            uint8_t off = _ioBuf[pos], len = _ioBuf[pos + 1];
+            if (off + len > size || pos + 2 + len > _pldSize) return 0xFFFF;
+            memcpy(&rec[off], &_ioBuf[pos + 2], len);
+            pos += 2 + len;
+        }
+    }
+    return back;
+#else
+    (void)rec; (void)size; (void)handle;
+    return 0xFFFF;
+#endif
+}
+
+/*
+ * WRITE-BACK
+ *
+ * With setWriteBack() write() copies the staged payload into the RAM slot of the partition
+ * (status 14) and returns at once. Bursts of writes where only the last value matters cost
+ * no sectors and no write budget. flush() writes the latest value as exactly one sector:
+ * explicitly, with idle() after EEPRWL_WRITE_BACK_MS, and with powerFail() from the
+ * power-fail detection. oneTickPassed() may run in an interrupt and never writes. A flush
+ * rejected by the write budget keeps the slot dirty and is repeated with the next idle(). isDirty()/dirtyAge() bound the data that a
+ * power loss can lose. read(0) returns the unsaved value.
+ */
+bool EEProm_Safe_Wear_Level::setWriteBack(bool enable, uint8_t handle) {
+    check_and_init
+    bool success = 0;
+#if EEPRWL_WRITE_BACK > 0
+    if (handle < EEPRWL_WRITE_BACK && _pldSize <= EEPRWL_WRITE_BACK_SIZE) {
+        success = 1;
+        if (enable) _wbMode |= (1 << handle);
+        else {
+            // The last value is written before the mode ends
+            success = flushSlot(handle);
+            _wbMode &= ~(1 << handle);
+        }
+    }
+#else
+    (void)enable;
+#endif
+    return_and_checksum success;
+}
+
+bool EEProm_Safe_Wear_Level::flush(uint8_t handle) {
+    check_and_init
+    bool success = flushSlot(handle);
+    return_and_checksum success;
+}
+
+// All dirty slots; returns false if one of them could not be written
+bool EEProm_Safe_Wear_Level::flush() {
+    bool success = 1;
+#if EEPRWL_WRITE_BACK > 0
+    for (uint8_t h = 0; h < EEPRWL_WRITE_BACK; h++) {
+        if ((_wbDirty & (1 << h)) && !flush(h)) success = 0;
+    }
+#endif
+    return success;
+}
+
+bool EEProm_Safe_Wear_Level::powerFail() {
+#if EEPRWL_WRITE_BACK > 0
+    _wbForce = true;
+    bool success = flush();
+    _wbForce = false;
+    return success;
+#else
+    return 1;
+#endif
+}
+
+bool EEProm_Safe_Wear_Level::isDirty(uint8_t handle) {
+#if EEPRWL_WRITE_BACK > 0
+    return handle < EEPRWL_WRITE_BACK && (_wbDirty & (1 << handle));
+#else
+    (void)handle;
+    return false;
+#endif
+}
+
+// Time in ms since the first unsaved write (0: nothing to save)
+uint32_t EEProm_Safe_Wear_Level::dirtyAge(uint8_t handle) {
+    if (!isDirty(handle)) return 0;
+#if EEPRWL_WRITE_BACK > 0
+    uint32_t age = millis() - _wbTime[handle];
+    return (age > 0) ? age : 1;
+#else
+    return 0;
+#endif
+}
+
+// write() in write-back mode: the staged payload in _ioBuf replaces the slot
+bool EEProm_Safe_Wear_Level::deferRecord(uint8_t handle, bool onlyIfChanged) {
+#if EEPRWL_WRITE_BACK > 0
+    uint8_t bit = 1 << handle;
+
+    // Unchanged against the unsaved value or (clean slot) against the newest record
+    bool same = (_wbDirty & bit) ? memcmp(_ioBuf, _wbBuf[handle], _pldSize) == 0 : unchangedRecord(handle);
+    if (onlyIfChanged && same) _status = 12;
+    else {
+        memcpy(_wbBuf[handle], _ioBuf, _pldSize);
+        if (!(_wbDirty & bit)) { _wbDirty |= bit; _wbTime[handle] = millis(); }
+        _status = 14;
+    }
+    _handle1 = handle;
+    _ioBuf[_secSize - 1] = 1;
+#else
+    (void)handle; (void)onlyIfChanged;
+#endif
+    return 1;
+}
+
+// One sector write with the latest value of the slot (nothing to do: true)
+bool EEProm_Safe_Wear_Level::flushSlot(uint8_t handle) {
+#if EEPRWL_WRITE_BACK > 0
+    if (handle >= EEPRWL_WRITE_BACK || !(_wbDirty & (1 << handle))) return 1;
+
+    if (counterFull()) { _status = 3; return 0; }
+    memcpy(_ioBuf, _wbBuf[handle], _pldSize);
+    bool success = writeRecord(handle);
+    if (success == 1) _wbDirty &= ~(1 << handle);
+    return success;
+#else
+    (void)handle;
+    return 1;
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+uint8_t EEProm_Safe_Wear_Level::getWrtAccBalance(uint8_t handle) {
+#if EEPRWL_TOKEN_BUCKETS > 0
+    if (handle < EEPRWL_TOKEN_BUCKETS && _tkBurst[handle] > 0) {
+        // Fill level of the token bucket on the same scale
+        tokenRefill(handle);
+        return _tkFill[handle] * 255 / ((uint32_t)_tkBurst[handle] << 8);
+    }
+#endif
+    return _buckPerm[handle & 7];
+}
+
+// Whole writes the next budget debits of the partition cover
+uint32_t EEProm_Safe_Wear_Level::getWriteTokens(uint8_t handle) {
+    check_and_init
+    uint32_t tokens;
+#if EEPRWL_TOKEN_BUCKETS > 0
+    if (handle < EEPRWL_TOKEN_BUCKETS) {
+        tokenRefill(handle);
+        tokens = _tkFill[handle] >> 8;
+    } else
+#endif
+    tokens = _budgetCycles[handle & 7] + (uint32_t)_buckPerm[handle & 7] * ((_buckCyc > 0) ? _buckCyc : 1);
+    return_and_checksum tokens;
+}
+
+/*
+ * TOKEN BUCKETS (EEPRWL_TOKEN_BUCKETS)
+ *
+ * Every partition below EEPRWL_TOKEN_BUCKETS has its own bucket instead of sharing one of
+ * the 8 credit buckets. A write costs 256 tokens; the refill adds rate16 tokens per clock
+ * step (rate16 / 16 writes per hour, 16 steps per hour), up to burst writes. Both are integer
+ * operations, so no fraction of a write is lost: 4 = one write every 4 hours, 8000 = 500
+ * writes per hour. The tick functions only advance _tkClock; the refill of a bucket is
+ * calculated from the steps since its last access (O(1), independent of the partitions).
+ * config() sets the rate and depth of the shared buckets (budgetCycles per hour, 255 hours),
+ * the fill level starts at the level of the persistent bucket (handle & 7).
+ */
+bool EEProm_Safe_Wear_Level::setWriteRate(uint16_t rate16, uint16_t burst, uint8_t handle) {
+    check_and_init
+    bool success = 0;
+#if EEPRWL_TOKEN_BUCKETS > 0
+    if (handle < EEPRWL_TOKEN_BUCKETS && burst > 0) {
+        // Tokens of the elapsed steps still at the old rate
+        tokenRefill(handle);
+        _tkRate[handle] = rate16;
+        _tkBurst[handle] = burst;
+        if (_tkFill[handle] > (uint32_t)burst << 8) _tkFill[handle] = (uint32_t)burst << 8;
+        success = 1;
+    }
+#else
+    (void)rate16; (void)burst;
+#endif
+    return_and_checksum success;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Streams the records of a partition to the visitor: from = 0 (current), 3 (oldest) or
+// 4 (newest) record, direction = 1 (to newer) or 2 (to older records), count = 0 (all).
+// Only valid sectors are passed on; the iteration ends when the logical counter sequence
+// breaks (wrap of the ring), after count records or when the visitor returns false.
+uint16_t EEProm_Safe_Wear_Level::forEachRecord(uint8_t from, uint16_t count, uint8_t direction, EEPRWL_Visitor visitor, uint8_t handle, void* context) {
+    check_and_init
+
+    uint16_t sector;
+
+    // Start sector
+    if (from == 3 || from == 4) {
+        if (!findMarginalSector(handle, 0)) { return_and_checksum 0; }
+        // _nextPhSec: successor of the newest sector = oldest sector of a wrapped ring
+        sector = _nextPhSec;
+        if (from == 4) sector = (sector == 0) ? _numSecs - 1 : sector - 1;
+    } else sector = (_nextPhSec == 0) ? _numSecs - 1 : _nextPhSec - 1;
+
+    return streamRecords(sector, count, (direction != 2), visitor, handle, context, 0xFFFFFFFF);
+}
+
+// Loop of forEachRecord() and forEachInTimeRange(), ends the call (_end). Going forward,
+// the iteration also ends at the first record with a timestamp > timeTo.
+uint16_t EEProm_Safe_Wear_Level::streamRecords(uint16_t sector, uint16_t count, bool forward, EEPRWL_Visitor visitor, uint8_t handle, void* context, uint32_t timeTo) {
+    uint16_t visited = 0;
+    uint32_t cnt, lastCnt = 0;
+
+    for (uint16_t i = 0; i < _numSecs; i++) {
+        if (readSector(sector, cnt) == SEC_VALID) {
+            // Counter sequence broken: all records of this direction passed
+            if (visited > 0 && (forward ? !cntAfter(cnt, lastCnt) : !cntAfter(lastCnt, cnt))) break;
+            if (forward && _tsLen > 0 && readLE(&_ioBuf[_pldSize + _cntLen], _tsLen) > timeTo) break;
+            lastCnt = cnt;
+            visited++;
+
+            // _ioBuf no longer holds the current record of read(0)
+            _handle1 = 0xFF;
+
+            // The visitor runs outside of the interrupt lock (it may call the library)
+            _end();
+            bool more = visitor(_ioBuf, cnt, context);
+            if (!_start(handle)) return visited;
+            if (!more || visited == count) break;
+        }
+
+        if (forward) sector = (sector + 1 >= _numSecs) ? 0 : sector + 1;
+        else sector = (sector == 0) ? _numSecs - 1 : sector - 1;
+    }
+
+    return_and_checksum visited;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+/*
+ * TIMESTAMPED RECORDS
+ *
+ * config(..., timeBytes) adds a timestamp of 1-4 bytes behind the logical counter
+ * (payload | counter | timestamp | checksum). write() stores clock() / resolution of
+ * setTimeSource() (default: millis(), resolution 1). As the writes run strictly
+ * sequentially, the timestamps rise with the logical counter, and the record of a point
+ * in time is found with a binary search over the counters of the ring: O(log n) sector
+ * reads instead of a scan of the partition.
+ *
+ * The timestamps are compared without wrap handling: the width must hold all timestamps
+ * of the partition (e.g. 2 bytes with resolution 60000: 45 days in minutes) and the clock
+ * must not restart lower after a reset (RTC or a clock continued by the application).
+ */
+void EEProm_Safe_Wear_Level::setTimeSource(EEPRWL_Clock clock, uint16_t resolution) {
+    _clock = clock;
+    _timeRes = (resolution == 0) ? 1 : resolution;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+bool EEProm_Safe_Wear_Level::findByTime(uint32_t time, uint8_t handle) {
+    check_and_init
+    if (_tsLen == 0) { _status = 16; return_and_checksum 0; }
+    bool success = findTime(time, handle);
+    return_and_checksum success;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+uint16_t EEProm_Safe_Wear_Level::forEachInTimeRange(uint32_t timeFrom, uint32_t timeTo, EEPRWL_Visitor visitor, uint8_t handle, void* context) {
+    check_and_init
+    if (_tsLen == 0) { _status = 16; return_and_checksum 0; }
+    if (timeFrom > timeTo || !findTime(timeFrom, handle)) { return_and_checksum 0; }
+
+    uint16_t sector = (_nextPhSec == 0) ? _numSecs - 1 : _nextPhSec - 1;
+    return streamRecords(sector, 0, 1, visitor, handle, context, timeTo / _timeRes);
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+uint32_t EEProm_Safe_Wear_Level::recordTime(uint8_t handle) {
+    check_and_init
+    uint32_t time = readLE(&_ioBuf[_pldSize + _cntLen], _tsLen) * _timeRes;
+    return_and_checksum time;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+uint32_t EEProm_Safe_Wear_Level::clockTime() {
+    return (uint32_t)((_clock != 0) ? _clock() : millis()) / _timeRes;
+}
+
+// Binary search for the oldest record with a timestamp >= time. The search runs over the
+// logical counters of the last ring (counterSector(): one sector read per step); corrupt
+// sectors are passed by probing the next counter. Found: position on this record.
+bool EEProm_Safe_Wear_Level::findTime(uint32_t time, uint8_t handle) {
+    if (!findMarginalSector(handle, 0)) return 0;
+
+    uint32_t t = time / _timeRes;
+    // Position 0 .. span-1 (oldest to newest) of the records that can be stored
+    uint16_t span = (rollover() || _curLgcCnt > _numSecs) ? _numSecs : _curLgcCnt;
+    uint16_t lo = 0, hi = span, sector, foundSec = 0;
+    uint32_t found = 0;
+
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2, c = mid;
+        while (c < hi && !counterSector(cntPrev(_curLgcCnt, span - 1 - c), sector)) c++;
+        if (c == hi) { hi = mid; continue; }
+
+        if (readLE(&_ioBuf[_pldSize + _cntLen], _tsLen) >= t) { found = cntPrev(_curLgcCnt, span - 1 - c); foundSec = sector; hi = mid; }
+        else lo = c + 1;
+    }
+
+    _handle1 = 0xFF;
+    if (found == 0) return 0;
+
+    // Record into _ioBuf, position as after read(): read(0) returns it, read(1) the next one
+    uint32_t cC;
+    readSector(foundSec, cC);
+    _ioBuf[_secSize - 1] = 1;
+    _curLgcCnt = found;
+    _nextPhSec = (foundSec + 1 >= _numSecs) ? 0 : foundSec + 1;
+    _handle1 = handle;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------------------
+bool EEProm_Safe_Wear_Level::findNewestData(uint8_t handle) {
+    check_and_init
+    bool success = findMarginalSector(handle, 0);
+    return_and_checksum success;
+}
+// ----------------------------------------------------------------------------------------------------
+bool EEProm_Safe_Wear_Level::findOldestData(uint8_t handle) {
+    check_and_init
+    bool success = findMarginalSector(handle, 1);
+    return_and_checksum success;
+}
+// ----------------------------------------------------------------------------------------------------
+// --- PRIVATE HELPER ---
+// ----------------------------------------------------------------------------------------------------
+
+void EEProm_Safe_Wear_Level::updateBuckets() {
+
+#if EEPRWL_PRIORITY_POOL > 0
+  // Reserve of the critical writes for the next hour
+  _prioPool = EEPRWL_PRIORITY_POOL;
+#endif
+#if EEPRWL_META_RING > 0
+  uint8_t states = _wlmStates;
+#endif
+  for (uint8_t i = 0; i < 8; i++) { 
+       if (_buckPerm[i] < 255) _buckPerm[i]++;
+       uint8_t level = _buckPerm[i];
+#if EEPRWL_TOKEN_BUCKETS > 0
+       // The token bucket of the handle persists its level in the same cell
+       if (i < EEPRWL_TOKEN_BUCKETS && _tkBurst[i] > 0) level = getWrtAccBalance(i);
+#endif
+#if EEPRWL_META_RING > 0
+       // All states in one ring record
+       if (level < 62) states &= ~(1 << i);
+       else if (level > 64) states |= (1 << i);
+#else
+       uint8_t value = e_r(_bucketStartAddr+i);
+       uint8_t stat = (level < 62) ? 0 : (level > 64) ? 127: value;
+       if (value != stat ) {
+               e_mw(_bucketStartAddr+i, stat);
+               e_c;
+       }
+#endif
+  }
+#if EEPRWL_META_RING > 0
+  if (states != _wlmStates) wlmSave(states);
+#endif
 
-        // Read sector checksum from EEPROM
-        crc = e_r(Address + x);
+}
+
+#if EEPRWL_TOKEN_BUCKETS > 0
+// Tokens of the clock steps since the last access, limited to the bucket depth
+void EEProm_Safe_Wear_Level::tokenRefill(uint8_t handle) {
+    uint32_t steps = _tkClock - _tkStamp[handle];
+    uint32_t cap = (uint32_t)_tkBurst[handle] << 8;
+    uint16_t rate = _tkRate[handle];
+    _tkStamp[handle] = _tkClock;
+
+    if (rate > 0 && steps > 0) {
+        uint32_t room = cap - _tkFill[handle];
+        _tkFill[handle] = (steps > room / rate) ? cap : _tkFill[handle] + steps * rate;
+    }
+}
 
-        // Calculate CRC based on the data read into _ioBuf
-        crc1 = calculateCRC(_ioBuf, _secSize - 1);
+// Start level: level of the persistent credit bucket (handle & 7) on the scale of the depth
+void EEProm_Safe_Wear_Level::tokenFill(uint8_t handle) {
+    _tkFill[handle] = ((uint32_t)_buckPerm[handle & 7] * _tkBurst[handle] / 255) << 8;
+}
+
+// budgetDebit() of a partition with token bucket
+uint16_t EEProm_Safe_Wear_Level::tokenDebit(uint8_t handle, uint16_t count) {
+    tokenRefill(handle);
+    uint32_t avail = _tkFill[handle] >> 8;
+    uint32_t cap = (uint32_t)_tkBurst[handle] << 8;
+    uint16_t n = (count > avail) ? avail : count;
+
+    if (n > 0) {
+        _tkFill[handle] -= (uint32_t)n << 8;
+        if (_tkFill[handle] < cap / 4) _status = 9;
+        else if (_tkFill[handle] < cap / 2) _status = 10;
+        else _status = 11;
+    }
 
-        if (crc == crc1) {
-            // The counter bytes are read starting from position _pldSize from the ioBuf
-            // (Little Endian).
-            cC = readLE(&_ioBuf[_pldSize], _cntLen);
-            // --- 2. Find the highest counter value ---
-            
-            if ((margin == 0 && _curLgcCnt <= cC) || (margin != 0 && _curLgcCnt > cC)) {
+    // Write shedding
+    if (n < count) _status = 8;
+    return n;
+}
+#endif
+
+/*
+ * PRIORITY CLASSES (EEPRWL_PRIORITY_POOL)
+ *
+ * Under overload all writes of a budget are shed alike (status 8). With priority classes a
+ * partition of EEPRWL_PRIO_LOW is shed as soon as the balance (getWrtAccBalance()) falls
+ * below 64, the rest of the budget stays with the normal and critical partitions of the same
+ * bucket. A write of EEPRWL_PRIO_CRITICAL that its budget cannot cover is taken from the
+ * reserve pool (status 18) instead of being shed; the pool allows EEPRWL_PRIORITY_POOL such
+ * writes per hour, so an alarm log is written at once and at a bounded extra rate.
+ */
+bool EEProm_Safe_Wear_Level::setPriority(uint8_t priority, uint8_t handle) {
+#if EEPRWL_PRIORITY_POOL > 0
+    if (handle < 16 && priority <= EEPRWL_PRIO_CRITICAL) {
+        _prioMap = (_prioMap & ~(3UL << (handle * 2))) | ((uint32_t)priority << (handle * 2));
+        return 1;
+    }
+#else
+    (void)priority; (void)handle;
+#endif
+    return 0;
+}
+
+// Writes of a priority class rejected by the write budget since the start
+uint32_t EEProm_Safe_Wear_Level::shedWrites(uint8_t priority) {
+#if EEPRWL_PRIORITY_POOL > 0
+    if (priority <= EEPRWL_PRIO_CRITICAL) return _prioShed[priority];
+#else
+    (void)priority;
+#endif
+    return 0;
+}
+
+// Writes of a priority class written and verified since the start
+uint32_t EEProm_Safe_Wear_Level::committedWrites(uint8_t priority) {
+#if EEPRWL_PRIORITY_POOL > 0
+    if (priority <= EEPRWL_PRIO_CRITICAL) return _prioDone[priority];
+#else
+    (void)priority;
+#endif
+    return 0;
+}
+
+uint8_t EEProm_Safe_Wear_Level::priority(uint8_t handle) {
+#if EEPRWL_PRIORITY_POOL > 0
+    if (handle < 16) return (_prioMap >> (handle * 2)) & 3;
+#else
+    (void)handle;
+#endif
+    return EEPRWL_PRIO_NORMAL;
+}
+
+void EEProm_Safe_Wear_Level::countCommitted(uint8_t handle, uint16_t count) {
+#if EEPRWL_PRIORITY_POOL > 0
+    _prioDone[priority(handle)] += count;
+#else
+    (void)handle; (void)count;
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+/*
+ * HEAD LOOKUP (O(log n))
+ *
+ * The writes run strictly sequentially around the ring. Beginning at physical sector 0,
+ * the sectors of the current lap therefore carry the counters c0, c0+1, c0+2 ... up to
+ * the newest sector. All sectors behind it belong to the previous lap (lower counter) or
+ * have never been written since the last format (empty). This makes the predicate
+ * "counter(i) == c0 + i" true for a prefix of the partition and false for the rest, so
+ * the wrap point can be found with a binary search.
+ *
+ * CRC-invalid (used) sectors are skipped by a short linear scan to the next readable
+ * sector. If the ring does not match the expected pattern (sector 0 unreadable,
+ * corrupted successor of the head, an empty gap before the previous lap, repositioned
+ * writes), the full linear scan is used.
+ */
+bool EEProm_Safe_Wear_Level::findMarginalSector(uint8_t handle, uint8_t margin) {
+    uint32_t c0, cC, cN;
+    uint16_t lo, hi, mid, n, found;
+    uint8_t st;
+    (void)handle;   // searches the selected partition
+
+    // --- 1. Anchor: physical sector 0 ---
+    if (readSector(0, c0) != SEC_VALID) return scanMarginalSector(margin);
+
+    // --- 2. Binary search for the last sector of the current lap ---
+    lo = 0; hi = _numSecs - 1;
+    while (lo < hi) {
+        mid = lo + ((hi - lo + 1) >> 1);
+        n = mid;
+        st = readSector(n, cC);
+        while (st == SEC_CORRUPT && n < hi) st = readSector(++n, cC);
+
+        if (st == SEC_VALID && cntDiff(cC, c0) == n) lo = n;
+        else hi = mid - 1;
+    }
+    if (lo > 0 && readSector(lo, cN) != SEC_VALID) return scanMarginalSector(margin);
+    if (lo == 0) cN = c0;
+
+    // --- 3. Verify with the successor of the head ---
+    // empty successor: ring not wrapped yet -> oldest is sector 0, the last sector must be
+    //   empty as well (an empty gap behind the head, e.g. the tail of a failed writeBatch(),
+    //   can be followed by records of the previous lap)
+    // valid successor: previous lap, counter must be exactly (newest - sectors + 1)
+    // stale successor (earlier format epoch): possibly a corrupted record of the current
+    //   lap that stopped the binary search early -> linear scan
+    found = 0;
+    if (lo + 1 < _numSecs) {
+        st = readSector(lo + 1, cC);
+        if (st == SEC_VALID && cntDiff(cN, cC) == _numSecs - 1u) found = lo + 1;
+        else if (st != SEC_EMPTY) return scanMarginalSector(margin);
+        else if (margin != 0 && lo + 2 < _numSecs && readSector(_numSecs - 1, cC) != SEC_EMPTY) return scanMarginalSector(margin);
+    } else cC = c0;
+
+    if (margin == 0) { found = lo; cC = cN; }
+    else if (found == 0) cC = c0;
+
+    _curLgcCnt = cC;
+    _nextPhSec = found + 1;
+    if (_nextPhSec >= _numSecs) _nextPhSec = 0;
+
+    // --- 4. Copy the found sector to the cache (only if it was not the last one read) ---
+    if ((margin == 0 && lo + 1 < _numSecs) || (margin != 0 && found == 0)) readSector(found, cC);
+
+    // Set the last uint8_t of the ioBuf as a RAM-internal status flag (1 = valid).
+    _ioBuf[_secSize - 1] = 1;
+    if (margin == 0) cacheNewest();
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Linear reference scan: reads every sector (fallback of findMarginalSector)
+bool EEProm_Safe_Wear_Level::scanMarginalSector(uint8_t margin) {
+    _curLgcCnt = 0; _nextPhSec = 0;  bool success = false;
+
+    // Search all sectors
+    // i MUST be uint16_t to support > 255 sectors (e.g., with 2KB EEPROM)
+    for (uint16_t i = 0; i < _numSecs; i++) {
+        uint32_t cC = 0;
+
+        // --- 1. Read sector into _ioBuf and check CRC ---
+        if (readSector(i, cC) == SEC_VALID) {
+            // --- 2. Find the highest counter value (serial number comparison: rollover) ---
+            if (!success || (margin == 0 && !cntAfter(_curLgcCnt, cC)) || (margin != 0 && cntAfter(_curLgcCnt, cC))) {
             // These assignments are identical in both successful cases
                 _curLgcCnt = cC;        // log. sector
                 _nextPhSec = i + 1;     // ph. sector
@@ -592,17 +2266,14 @@ bool EEProm_Safe_Wear_Level::findMarginalSector(uint8_t handle, uint8_t margin)
 
     // --- 3. Copy the found sector to the cache and set status ---
     if (success == true) {
-        // c must be uint16_t to store the index of the found sector
-        uint16_t c = _nextPhSec - 1;
-
         // Read the sector (data and counter) with the highest counter value AGAIN
         // into the ioBuf.
-        for (uint16_t x = 0; x < (_secSize - 1); x++) {
-            _ioBuf[x] = e_r(_startAddr + METADATA_SIZE + (c * _secSize) + x);
-        }
+        uint32_t cC;
+        readSector(_nextPhSec - 1, cC);
 
         // Set the last uint8_t of the ioBuf as a RAM-internal status flag (1 = valid).
         _ioBuf[_secSize - 1] = 1;
+        if (margin == 0) cacheNewest();
     } else {
         // Set the status flag (0 = invalid) if no valid sector was found.
          _ioBuf[_secSize - 1] = 0;
@@ -610,74 +2281,382 @@ bool EEProm_Safe_Wear_Level::findMarginalSector(uint8_t handle, uint8_t margin)
 
     // Handle overflow: If the counter has reached the end of the partition,
     // start again at 0
-    if (_nextPhSec > _numSecs) _nextPhSec = 0;
+    if (_nextPhSec >= _numSecs) _nextPhSec = 0;
 
     return success;
 }
 
 // ----------------------------------------------------------------------------------------------------
 
-uint8_t EEProm_Safe_Wear_Level::calculateCRC(const uint8_t *data, size_t length) {
-    uint8_t crc = 0x00; // Initial value 0 (often also 0xFF, here 0x00 for simplicity/compactness)
-	
-    for (size_t i = 0; i < length; i++) {
-        if (data[i] > 0) _usedSector = 1;
-        crc ^= data[i]; // XOR with the next data byte
-        for (uint8_t j = 0; j < 8; j++) {
-            if (crc & 0x80) { // Check if the MSB is set
-                // Shift und XOR mit dem Polynom
-                crc = (crc << 1) ^ 7; // Standard CRC-8 polynomial x^8 + x^2 + x^1 + 1 (0x07)
-            } else {
-                // only Shift
-                crc <<= 1;
-            }
-        }
+// Reads physical sector (0 .. _numSecs-1) into _ioBuf and checks its CRC.
+// Returns SEC_VALID (counter in cnt), SEC_EMPTY (formatted, never written), SEC_STALE
+// (checksum of an earlier format epoch) or SEC_CORRUPT.
+uint8_t EEProm_Safe_Wear_Level::readSector(uint16_t sector, uint32_t& cnt) {
+    uint16_t dLen = _secSize - CRC_LEN;
+    uint16_t Address = sectorAddr(sector);
+
+    // Read data, counter and the sector checksum (CRC_LEN bytes) from EEPROM
+    e_rb(Address, _ioBuf, _secSize);
+
+    // A sector with only zero bytes (payload + counter) is an unused (formatted) sector,
+    // a sector with only 0xFF bytes an erased one (skipped by the format).
+    _usedSector = usedBytes(_ioBuf, dLen) && !erasedBytes(_ioBuf, _secSize);
+    if (_usedSector == 0) return SEC_EMPTY;
+
+    // Compare with the checksum calculated from the data read into _ioBuf,
+    // the format epoch is mixed into the checksum: 0 = valid record of this epoch.
+    SectorChk diff = (SectorChk)readLE(&_ioBuf[dLen], CRC_LEN) ^ calculateCRC(_ioBuf, dLen) ^ _epoch;
+    if (diff == 0 || eccRepair(diff)) {
+        cnt = readLE(&_ioBuf[_pldSize], _cntLen);
+        return SEC_VALID;
     }
-	
-    return crc;
+
+    // Record of an earlier epoch since the last zero-fill (lazy format): unused. A corrupted
+    // record of this epoch can match as well, so the head searches do not rely on it.
+    if ((SectorChk)(diff ^ _epoch) < _epoch) { _usedSector = 0; return SEC_STALE; }
+#if EEPRWL_ECC > 0
+    _eccLost++;
+#endif
+    return SEC_CORRUPT;
+}
+
+// Check word (EEPRWL_ECC) and checksum of the sector image in _ioBuf
+void EEProm_Safe_Wear_Level::sealSector() {
+#if EEPRWL_ECC > 0
+    uint16_t dLen = _secSize - CRC_LEN - ECC_LEN;
+    writeLE(&_ioBuf[dLen], eeprwlEcc(_ioBuf, dLen), ECC_LEN);
+#endif
+    writeLE(&_ioBuf[_secSize - CRC_LEN], calculateCRC(_ioBuf, _secSize - CRC_LEN) ^ _epoch, CRC_LEN);
+}
+
+// Sector in _ioBuf with a checksum error (diff: stored ^ calculated checksum ^ epoch): a
+// single bit error of the data, the check word or the checksum is corrected (EEPRWL_ECC).
+// Returns true if the corrected sector passes the checksum.
+bool EEProm_Safe_Wear_Level::eccRepair(SectorChk diff) {
+#if EEPRWL_ECC > 0
+    uint16_t dLen = _secSize - CRC_LEN - ECC_LEN;
+    uint16_t check = readLE(&_ioBuf[dLen], ECC_LEN);
+
+    switch (eeprwlEccCorrect(_ioBuf, dLen, check)) {
+      case 0:
+        // Data and check word intact: one flipped checksum bit, but not a record of an
+        // earlier epoch (lazy format)
+        if ((diff & (diff - 1)) != 0 || (SectorChk)(diff ^ _epoch) < _epoch) return false;
+        break;
+      case 1:
+        writeLE(&_ioBuf[dLen], check, ECC_LEN);
+        if ((SectorChk)readLE(&_ioBuf[dLen + ECC_LEN], CRC_LEN) != (SectorChk)(calculateCRC(_ioBuf, dLen + ECC_LEN) ^ _epoch)) return false;
+        break;
+      default:
+        return false;
+    }
+
+    _eccFixed++;
+    return true;
+#else
+    (void)diff;
+    return false;
+#endif
+}
+
+uint32_t EEProm_Safe_Wear_Level::eccCorrected() {
+#if EEPRWL_ECC > 0
+    return _eccFixed;
+#else
+    return 0;
+#endif
+}
+
+uint32_t EEProm_Safe_Wear_Level::eccUncorrectable() {
+#if EEPRWL_ECC > 0
+    return _eccLost;
+#else
+    return 0;
+#endif
+}
+
+// Physical address of a sector. With a paged backend the sectors are packed into the
+// pages (_secPerPage per page) and never straddle a page boundary.
+uint16_t EEProm_Safe_Wear_Level::sectorAddr(uint16_t sector) {
+#if EEPRWL_SPARE_SECTORS > 0
+    // Retired ring sector: its spare
+    sector = spareOf(sector);
+#endif
+    if (_secPerPage == 0) return _startAddr + METADATA_SIZE + sector * _secSize;
+    return _pageBase + (sector / _secPerPage) * _io->pageSize() + (sector % _secPerPage) * _secSize;
+}
+
+// Sector placement for the active partition (_secSize must be set)
+void EEProm_Safe_Wear_Level::pageGeometry() {
+    uint16_t page = _io->pageSize();
+
+    // No pages, or the sector is larger than a page: consecutive sectors
+    _secPerPage = (page >= _secSize) ? page / _secSize : 0;
+    if (_secPerPage > 0) _pageBase = pageBase(_startAddr, page);
 }
 
 // ----------------------------------------------------------------------------------------------------
 
-void EEProm_Safe_Wear_Level::formatInternal(uint8_t handle) {
-    
-    // Iterate through all sectors
+// Keeps a RAM copy of the newest record payload (_ioBuf) of the active partition.
+// Used by the skip-unchanged mode of write().
+// _ioBuf holds the newest record, _curLgcCnt and _nextPhSec are set
+void EEProm_Safe_Wear_Level::cacheNewest() {
+    memcpy(_lastBuf, _ioBuf, _pldSize);
+    _lastHandle = _handle;
+#if EEPRWL_RECORD_CACHE > 0
+    if (_handle < EEPRWL_RECORD_CACHE && _pldSize <= EEPRWL_RECORD_CACHE_SIZE) {
+        memcpy(_recBuf[_handle], _ioBuf, _pldSize);
+        _recCnt[_handle] = _curLgcCnt;
+        _recNext[_handle] = (_nextPhSec >= _numSecs) ? 0 : _nextPhSec;
+    }
+#endif
+}
 
-    union U16toB {uint16_t u16;uint8_t u8[2];}; 
-    U16toB __EEPRWL_VER; __EEPRWL_VER.u16 = _EEPRWL_VER; 
-    __EEPRWL_VER.u8[0] = e_r(_startAddr + 2);
-    __EEPRWL_VER.u8[1] = e_r(_startAddr + 3);
-    __EEPRWL_VER.u16++;
-    e_w(_startAddr + 2, __EEPRWL_VER.u8[0]);
-    e_w(_startAddr + 3, __EEPRWL_VER.u8[1]);
+// The newest record of the partition is unknown (write failure, format, pending job)
+void EEProm_Safe_Wear_Level::dropNewest(uint8_t handle) {
+    if (_lastHandle == handle) _lastHandle = 0xFF;
+#if EEPRWL_RECORD_CACHE > 0
+    if (handle < EEPRWL_RECORD_CACHE) _recCnt[handle] = 0;
+#endif
+}
+
+// read(0) after a handle switch: if the partition stands at its newest record (logical
+// counter and position unchanged since it was cached), _ioBuf is filled from the record
+// cache like loadPhysSector() would fill it from the EEPROM.
+bool EEProm_Safe_Wear_Level::loadNewest(uint8_t handle) {
+#if EEPRWL_RECORD_CACHE > 0
+    if (handle >= EEPRWL_RECORD_CACHE || _recCnt[handle] == 0 || _recCnt[handle] != _curLgcCnt) return false;
+    if (_recNext[handle] != _nextPhSec) return false;
+
+    memcpy(_ioBuf, _recBuf[handle], _pldSize);
+    _ioBuf[_secSize - 1] = 1;
+    _status = 1;
+    return true;
+#else
+    (void)handle;
+    return false;
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+/*
+ * HEAD HINT
+ *
+ * The metadata block holds HINT_SLOTS hint slots (physical sector LE16 + sequence byte).
+ * Every _hintInt records the sector of the record just written is stored in the next slot.
+ * Each slot is thus rewritten every HINT_SLOTS * _hintInt >= _numSecs records, i.e. not
+ * more often than a data sector. At boot the newest slot (break in the sequence) gives the
+ * head with at most _hintInt records of delay, which is closed by a binary search over
+ * this window. The result is verified like in findMarginalSector(); a stale or corrupted
+ * hint returns false and the caller falls back to the full search.
+ * The interval is hintInterval() in the header (constexpr, also used by EEPromPartition).
+ * Only with EEPRWL_HEAD_HINTS (the slots change the layout), otherwise _hintInt is 0.
+ */
+
+// ----------------------------------------------------------------------------------------------------
+
+void EEProm_Safe_Wear_Level::writeHint(uint16_t sector) {
+    uint8_t slot[3];
+
+    e_mwb(hintSlot(sector, slot, _curLgcCnt), slot, 3);
     e_c;
+}
 
-    for (uint16_t i = 0; i < _numSecs; i++) {
+// Hint entry of the record with the logical counter cnt: fills slot (sector LE16,
+// sequence byte) and returns its EEPROM address
+uint16_t EEProm_Safe_Wear_Level::hintSlot(uint16_t sector, uint8_t* slot, uint32_t cnt) {
+    uint32_t seq = cnt / _hintInt;
+
+    slot[0] = (uint8_t)sector; slot[1] = (uint8_t)(sector >> 8); slot[2] = (uint8_t)seq;
+    return _startAddr + HINT_ADDR + 3 * (seq % HINT_SLOTS);
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+bool EEProm_Safe_Wear_Level::restoreHead() {
+#if EEPRWL_HEAD_HINTS > 0
+    uint8_t seq[HINT_SLOTS];
+    uint16_t sec[HINT_SLOTS];
+    uint16_t lo, hi, mid, head;
+    uint32_t cH, cC;
+    uint8_t j, k, st;
+    uint8_t slot[3];
+
+    if (_hintInt == 0) return false;
+
+    // --- 1. Read the hint slots (sector low, high, sequence) ---
+    for (j = 0; j < HINT_SLOTS; j++) {
+        e_rb(_startAddr + HINT_ADDR + 3 * j, slot, 3);
+        sec[j] = ((uint16_t)slot[1] << 8) | slot[0];
+        seq[j] = slot[2];
+    }
+
+    // --- 2. Newest slot: its successor slot does not continue the sequence ---
+    for (j = 0; j < HINT_SLOTS; j++) {
+        k = (j + 1) % HINT_SLOTS;
+        if (sec[j] < _numSecs && (sec[k] >= _numSecs || seq[k] != (uint8_t)(seq[j] + 1))) break;
+    }
+    if (j == HINT_SLOTS) return false;
+
+    head = sec[j];
+    if (readSector(head, cH) != SEC_VALID || (uint8_t)(cH / _hintInt) != seq[j]) return false;
+
+    // --- 3. Binary search for the head within the hint window (offset 0 .. _hintInt) ---
+    lo = 0; hi = _hintInt;
+    while (lo < hi) {
+        mid = lo + ((hi - lo + 1) >> 1);
+        st = readSector((head + mid) % _numSecs, cC);
+        if (st == SEC_CORRUPT) return false;
+        if (st == SEC_VALID && cntDiff(cC, cH) == mid) lo = mid;
+        else hi = mid - 1;
+    }
+    // hint older than the window: stale
+    if (lo == _hintInt) return false;
+    cH = cntNext(cH, lo); head = (head + lo) % _numSecs;
+
+    // --- 4. Verify with the successor of the head (empty or previous lap) ---
+    st = readSector((head + 1) % _numSecs, cC);
+    if (!(st == SEC_EMPTY || (st == SEC_VALID && cntDiff(cH, cC) == _numSecs - 1u))) return false;
+
+    // --- 5. Restore the head and copy the newest sector to the cache ---
+    readSector(head, cC);
+    _ioBuf[_secSize - 1] = 1;
+    _curLgcCnt = cH;
+    _nextPhSec = head + 1;
+    if (_nextPhSec >= _numSecs) _nextPhSec = 0;
+    cacheNewest();
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Sector checksum, engine selected with EEPRWL_CHECKSUM (EEProm_Safe_Wear_Level_Checksum.h)
+SectorChk EEProm_Safe_Wear_Level::calculateCRC(const uint8_t *data, size_t length) {
+#if EEPRWL_CHECKSUM == EEPRWL_CRC8
+    return eeprwlCrc8(data, length);
+#elif EEPRWL_CHECKSUM == EEPRWL_CRC8_TABLE
+    return eeprwlCrc8Table(data, length);
+#elif EEPRWL_CHECKSUM == EEPRWL_CRC16
+    return eeprwlCrc16(data, length);
+#elif EEPRWL_CHECKSUM == EEPRWL_FLETCHER16
+    return eeprwlFletcher16(data, length);
+#else
+    return eeprwlCrc8Nibble(data, length);
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+/*
+ * FORMAT
+ *
+ * Invalidating the records does not need a write to every sector: each format increments
+ * the overwrite counter and starts a new format epoch (0..EEPRWL_LAZY_FORMAT, bits 4-6 of
+ * the Magic ID), which is mixed into the sector checksums. The records of the earlier
+ * epochs fail the checksum of the new one and are read as empty (readSector(): checksum
+ * difference = earlier epoch). A lazy format thus writes only the metadata. After
+ * EEPRWL_LAZY_FORMAT lazy formats, for a new layout (the old sectors are not aligned with
+ * the new ones) and on first use, the sectors are zero-filled (epoch 0, zeroSectors() from
+ * restoreStep()). Erased sectors (only 0xFF, e.g. a new EEPROM) are already empty and are
+ * not written.
+ */
+void EEProm_Safe_Wear_Level::formatInternal() {
+    dropNewest(_handle);
+
+#if EEPRWL_META_RING == 0
+    // Metadata ring: counted in the record written at the end of the format (restoreStep())
+    bumpOverwCounter();
+#endif
+
+#if EEPRWL_HEAD_HINTS > 0
+    // Invalidate the head hints (0xFF)
+    for (uint8_t x = 0; x < 3 * HINT_SLOTS; x++) {
+        if (e_r(_startAddr + HINT_ADDR + x) != 0xFF) e_mw(_startAddr + HINT_ADDR + x, (uint8_t)0xFF);
+    }
+    e_c;
+#endif
+}
+
+// Zero-fills the sectors from 'from' on, at least count sectors (paged backend: whole pages).
+// Returns the next sector to fill (_numSecs: done).
+uint16_t EEProm_Safe_Wear_Level::zeroSectors(uint16_t from, uint16_t count) {
+    uint16_t i = from;
+    uint16_t to = (count < _numSecs - from) ? from + count : _numSecs;
+
+    if (_io->pageSize() == 0) {
+      for (; i < to; i++) {
         uint16_t x;
 
         // **Optimization 1: Address calculation**
         // Calculate the base address of the current sector once (Speed/Readability)
-        uint16_t baseAddr = _startAddr + METADATA_SIZE + (i * _secSize);
+        uint16_t baseAddr = sectorAddr(i);
+
+        // Erased sector: nothing to write
+        e_rb(baseAddr, _ioBuf, _secSize);
+        if (erasedBytes(_ioBuf, _secSize)) continue;
 
-        // 1. Data bytes & counter (initialize with 0x00)
-        for (x = 0; x < _pldSize + _cntLen; x++) {
+        // 1. Data bytes, counter & timestamp (initialize with 0x00)
+        for (x = 0; x < _secSize - CRC_LEN; x++) {
             // **Optimization 2: EEPROM Wear-Leveling**
             // Only write if the value in EEPROM != 0x00.
-            if (e_r(baseAddr + x) != 0x00) {
+            if (_ioBuf[x] != 0x00) {
                 e_w(baseAddr + x, (uint8_t)0x00);
             }
         }
 
-        // 2. Checksum (initialize with 0xF0)
-        // x is now at the correct index for the CRC byte
+        // 2. Checksum (initialize with 0xF0, never valid for zero data)
+        // x is now at the correct index for the checksum bytes
         // **Optimization 2: EEPROM Wear-Leveling**
-        if (e_r(baseAddr + x) != 0xF0) {
-            e_w(baseAddr + x, (uint8_t)0xF0);
+        for (; x < _secSize; x++) {
+            if (_ioBuf[x] != 0xF0) {
+                e_w(baseAddr + x, (uint8_t)0xF0);
+            }
+        }
+
+        e_c;
+      }
+    } else {
+      // **Optimization 3: Paged backend (external EEPROM)**
+      // The sectors of one page are compared with one block read and programmed
+      // with one burst (FORMAT_BURST bytes), instead of one write cycle per byte.
+      uint8_t buf[FORMAT_BURST];
+      // Retired sectors: single sectors, the spares are not part of a page run
+      uint16_t run = (_secPerPage > 0 && remapLoad() == 0) ? _secPerPage : 1;
+
+      for (; i < to; i += run) {
+        uint16_t baseAddr = sectorAddr(i);
+        uint16_t n = ((_numSecs - i < run) ? _numSecs - i : run) * _secSize;
+
+        // Erased page: nothing to write
+        bool erased = true;
+        for (uint16_t o = 0; o < n && erased; o += FORMAT_BURST) {
+            uint8_t len = (n - o > FORMAT_BURST) ? FORMAT_BURST : n - o;
+            e_rb(baseAddr + o, buf, len);
+            erased = erasedBytes(buf, len);
         }
+        if (erased) continue;
 
+        for (uint16_t o = 0; o < n; o += FORMAT_BURST) {
+            uint8_t len = (n - o > FORMAT_BURST) ? FORMAT_BURST : n - o;
+            bool differs = false;
+
+            e_rb(baseAddr + o, buf, len);
+            for (uint8_t k = 0; k < len; k++) {
+                uint8_t v = ((o + k) % _secSize < _secSize - CRC_LEN) ? 0x00 : 0xF0;
+                if (buf[k] != v) { buf[k] = v; differs = true; }
+            }
+            if (differs) e_wb(baseAddr + o, buf, len);
+        }
         e_c;
+      }
     }
 
+    return (i < _numSecs) ? i : _numSecs;
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -686,7 +2665,7 @@ void EEProm_Safe_Wear_Level::formatInternal(uint8_t handle) {
  * Disables interrupts (cli). Replaces check_and_init.
  */
 bool EEProm_Safe_Wear_Level::_start(uint8_t handle) {
-    cli(); 
+    irq_off(); 
     bool success = 1;
 	
     if (_handle != handle) {
@@ -694,18 +2673,56 @@ bool EEProm_Safe_Wear_Level::_start(uint8_t handle) {
 	size_t offset = (size_t)handle * CONTROL_STRUCT_SIZE;
 	_controlCache = (ControlData*)(_ramStart + offset);
     	_handle = handle;
-    	_ctlLen = _cntLen + 1;
+    	_ctlLen = _cntLen + _tsLen + ECC_LEN + CRC_LEN;
     	_secSize = _pldSize + _ctlLen;
-    	_maxLgcCnt = (maxCapacity / _numSecs) * _numSecs;
+    	_maxLgcCnt = counterLimit(_cntLen, _numSecs);
+    	_hintInt = hintInterval(_numSecs);
+    	pageGeometry();
     }
     
-    if (_checksum != chkSum()) { _status = 5; sei(); success = 0; }
+    if (_checksum != chkSum()) { _status = 5; irq_on(); success = 0; }
+#if EEPRWL_LAZY_INIT > 0
+    else if (handle < 16 && (_restoring & (1U << handle))) restorePending(handle);
+#endif
+#if EEPRWL_LOCK == EEPRWL_LOCK_SHORT
+    else {
+#if defined(ASYNC_IRQ)
+        // The EEPROM I/O of this call must not interleave with the interrupt engine
+        EECR &= ~(1 << EERIE);
+#endif
+        // Control block checked: the EEPROM I/O runs with interrupts enabled
+        irq_on();
+    }
+#endif
   
     return success;
 }
 
 void EEProm_Safe_Wear_Level::_end() {
-    _checksum = chkSum(); sei();
+#if EEPRWL_LOCK == EEPRWL_LOCK_SHORT
+    irq_off();
+#if defined(ASYNC_IRQ)
+    if (EEPRWL_asyncOwner != 0 && EEPRWL_asyncOwner->asyncState() == EEPRWL_ASYNC_BUSY) EECR |= (1 << EERIE);
+#endif
+#endif
+    _checksum = chkSum(); irq_on();
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+// Handle switch with the constant geometry of an EEPromPartition: no calculation in _start()
+void EEProm_Safe_Wear_Level::selectPartition(uint8_t handle, uint8_t ctlLen, uint16_t secSize, uint32_t maxLgcCnt, uint16_t hintInt) {
+    if (_handle == handle) return;
+
+    irq_off();
+    _controlCache = (ControlData*)(_ramStart + (size_t)handle * CONTROL_STRUCT_SIZE);
+    _handle = handle;
+    _ctlLen = ctlLen;
+    _secSize = secSize;
+    _maxLgcCnt = maxLgcCnt;
+    _hintInt = hintInt;
+    pageGeometry();
+    irq_on();
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -16,10 +16,12 @@
  * along with this library. If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************************************
  *
- * EEPROM MACROS:
+ * EEPROM MACROS (bound to the storage backend, see EEProm_Safe_Wear_Level_Storage.h):
  * e_r	: read
  * e_w	: write
  * e_c	: commit
+ * e_rb	: block read
+ * e_wb	: block write
  * -------------------------------------------------------------
 */
 #ifndef EEPROM_WEAR_LEVEL_H
@@ -28,26 +30,63 @@
 // ----------------------------------------------------------------------------------------------------
 // --- INCLUDES & MACROS ---
 // ----------------------------------------------------------------------------------------------------
-#include <EEPROM.h>
-#include <Arduino.h>
+#if defined(ARDUINO)
+  #include <EEPROM.h>
+  #include <Arduino.h>
+#else
+  #include "EEProm_Safe_Wear_Level_Host.h"
+#endif
 #include <stddef.h>
 #include <string.h>
 #include <stdint.h>
+#include "EEProm_Safe_Wear_Level_Storage.h"
 #include "EEProm_Safe_Wear_Level_Macros.h"
+// Compile-time partition (EEProm_Safe_Wear_Level_Partition.h)
+template <uint16_t Start, uint16_t Size, uint8_t Payload, uint8_t CntLen, uint16_t MemSize, uint16_t PageSize, uint8_t TimeLen>
+class EEPromPartition;
+
+// Visitor of forEachRecord(): payload of a valid record and its logical counter.
+// Return false to stop the iteration.
+typedef bool (*EEPRWL_Visitor)(const uint8_t* payload, uint32_t counter, void* context);
+
+// Time source of the record timestamps: same signature as millis() (e.g. an RTC in seconds)
+typedef unsigned long (*EEPRWL_Clock)();
+
 // ----------------------------------------------------------------------------------------------------
 // --- CLASS DEFINITION ---
 // ----------------------------------------------------------------------------------------------------
 class EEProm_Safe_Wear_Level {
     public:
-      // Standard Constructor
+#if defined(ARDUINO)
+      // Standard Constructor (internal EEPROM)
       EEProm_Safe_Wear_Level(uint8_t* ramHandlePtr, uint16_t seconds = 8);
+#endif
+      // Constructor with storage backend (external EEPROM, FRAM, RAM)
+      EEProm_Safe_Wear_Level(uint8_t* ramHandlePtr, EEPRWL_Storage& storage, uint16_t seconds = 8);
 
       // Check account balance for write cycles
       uint8_t getWrtAccBalance(uint8_t handle);
+      // Writes currently covered by the write budget of the partition
+      uint32_t getWriteTokens(uint8_t handle);
+      // Token bucket (EEPRWL_TOKEN_BUCKETS): refill in 1/16 write per hour, depth in writes
+      bool setWriteRate(uint16_t rate16, uint16_t burst, uint8_t handle);
+      // Priority class of the partition for Write Shedding (EEPRWL_PRIORITY_POOL)
+      bool setPriority(uint8_t priority, uint8_t handle);
+      uint32_t shedWrites(uint8_t priority);
+      uint32_t committedWrites(uint8_t priority);
+      // Write cycles of the most worn metadata cell of the partition (format, rollover)
+      uint16_t metaWear(uint8_t handle);
+      // Sectors retired to a spare sector after a failed verify (EEPRWL_SPARE_SECTORS)
+      uint8_t retiredSectors(uint8_t handle);
+      // Sector reads corrected by the ECC / failed despite the ECC since the start (EEPRWL_ECC)
+      uint32_t eccCorrected();
+      uint32_t eccUncorrectable();
+      // Delta encoding of write() / read(0, ...) (EEPRWL_DELTA): keyframe every n records
+      bool setDelta(bool enable, uint8_t keyframeEvery, uint8_t handle);
 
       // --- PUBLIC API (Implementation in .cpp) ---
       // Parameter names (startAddress, totalBytesUsed, PayloadSize) are deliberately NOT abbreviated.
-      uint16_t config(uint16_t startAddress = 0, uint16_t totalBytesUsed = 256, uint8_t PayloadSize = 2, uint8_t cntLengthBytes = 3, uint8_t budgetCycles = 20, uint8_t handle = 0);
+      uint16_t config(uint16_t startAddress = 0, uint16_t totalBytesUsed = 256, uint8_t PayloadSize = 2, uint8_t cntLengthBytes = 3, uint8_t budgetCycles = 20, uint8_t handle = 0, uint8_t timeBytes = 0);
       uint16_t getOverwCounter(uint8_t handle);
       bool initialize(bool forceFormat, uint8_t handle);
       
@@ -60,9 +99,15 @@ class EEProm_Safe_Wear_Level {
       // Loads sector into the cache (Implementation in .cpp)
       uint16_t loadPhysSector(uint16_t physSector, uint8_t handle);
       bool migrateData(uint8_t sourceHandle, uint8_t targetHandle, uint16_t count);
+      // Incremental migration: the job is copied in steps (also by idle()), see migrateStep()
+      bool migrateBegin(uint8_t sourceHandle, uint8_t targetHandle, uint16_t count);
+      uint16_t migrateStep(uint8_t maxRecords);
+      uint16_t migratePending();
+      // Partition restored (EEPRWL_LAZY_INIT: false until idle() or the first access)
+      bool isRestored(uint8_t handle);
       // ----------------------------------------------------------------------------------------------------
       uint32_t getCtrlData(uint8_t offs, uint8_t handle) {
-      	    static uint8_t const leng[] = {4,0,0,0, 2,0, 2,0, 2,0, 1, 1, 2,0, 1, 1};
+      	    static uint8_t const leng[] = {4,0,0,0, 2,0, 2,0, 2,0, 1, 1, 1, 1, 1, 1};
             check_and_init
 		   
 	    int start_index = (handle * 16) + offs;
@@ -84,25 +129,105 @@ class EEProm_Safe_Wear_Level {
       bool findNewestData(uint8_t handle);
       bool findOldestData(uint8_t handle);
 
+      // Streams the valid records (payload in the I/O buffer, logical counter) to a visitor
+      uint16_t forEachRecord(uint8_t from, uint16_t count, uint8_t direction, EEPRWL_Visitor visitor, uint8_t handle, void* context = 0);
+
+      // --- TIMESTAMPED RECORDS (config() with timeBytes > 0) ---
+      // Clock of the timestamps (default millis()), stored as clock() / resolution
+      void setTimeSource(EEPRWL_Clock clock, uint16_t resolution = 1);
+      // Positions the partition at the oldest record with a timestamp >= time
+      bool findByTime(uint32_t time, uint8_t handle);
+      // Streams the records with timeFrom <= timestamp <= timeTo (to newer records)
+      uint16_t forEachInTimeRange(uint32_t timeFrom, uint32_t timeTo, EEPRWL_Visitor visitor, uint8_t handle, void* context = 0);
+      // Timestamp (clock units) of the record in the I/O buffer (visitor, after findByTime())
+      uint32_t recordTime(uint8_t handle);
+
+      // --- WRITE-BACK (EEPRWL_WRITE_BACK) ---
+      // write() only updates a RAM slot, flush() writes the latest value as one sector
+      bool setWriteBack(bool enable, uint8_t handle);
+      bool flush(uint8_t handle);
+      bool flush();
+      // Flush of all slots without write budget check (power-fail / brown-out warning)
+      bool powerFail();
+      bool isDirty(uint8_t handle);
+      uint32_t dirtyAge(uint8_t handle);
+
+      // --- SECTOR GEOMETRY (constexpr: used by config() and by EEPromPartition) ---
+      // Number of ring sectors of a partition (page packing for paged backends, without spares)
+      static constexpr uint16_t sectorCount(uint16_t start, uint16_t size, uint16_t secSize, uint16_t page) {
+          return (physCount(start, size, secSize, page) > EEPRWL_SPARE_SECTORS)
+               ? physCount(start, size, secSize, page) - EEPRWL_SPARE_SECTORS : 0;
+      }
+      // Number of sectors that fit into the partition (ring and spare sectors), 0 if the
+      // partition does not even hold its metadata
+      static constexpr uint16_t physCount(uint16_t start, uint16_t size, uint16_t secSize, uint16_t page) {
+          return (size <= METADATA_SIZE) ? 0
+               : (page < secSize) ? (size - METADATA_SIZE) / secSize
+               : pagedCount(((uint32_t)start + size > pageBase(start, page)) ? start + size - pageBase(start, page) : 0, secSize, page);
+      }
+      // First page boundary after the metadata
+      static constexpr uint16_t pageBase(uint16_t start, uint16_t page) {
+          return ((start + METADATA_SIZE + page - 1) / page) * page;
+      }
+      // Rollover after a full number of rotations (counter length 1 to 4 bytes)
+      static constexpr uint32_t counterLimit(uint8_t cntLen, uint16_t sectors) {
+          return (((cntLen >= 4) ? 0xFFFFFFFFUL : (1UL << (cntLen * 8)) - 1) / sectors) * sectors;
+      }
+      // Head hint every sectors / 4 records (EEPRWL_HEAD_HINTS); small partitions: the binary search is cheaper
+      static constexpr uint16_t hintInterval(uint16_t sectors) {
+          return (EEPRWL_HEAD_HINTS == 0 || sectors <= 2 * HINT_SLOTS) ? 0 : (sectors + HINT_SLOTS - 1) / HINT_SLOTS;
+      }
 
       // --- GENERIC TEMPLATE FUNCTIONS ---
       
       template <typename T>
-      bool write(const T& value, uint8_t handle);
+      bool write(const T& value, uint8_t handle, bool onlyIfChanged = false);
       template <typename T>
       bool read(uint8_t ReadMode, T& value, uint8_t handle, size_t maxSize = 0);
       // --- EXPLICIT OVERLOADS FOR C-STRINGS (Implementation in .cpp) ---
       
-      bool write(const char* value, uint8_t handle);
+      bool write(const char* value, uint8_t handle, bool onlyIfChanged = false);
       bool read(uint8_t ReadMode, char* value, uint8_t handle, size_t maxSize = 0);
+
+      // Random access by logical counter (absolute, or relative to the current record)
+      template <typename T>
+      bool readByCounter(uint32_t counter, T& value, uint8_t handle);
+      template <typename T>
+      bool readRelative(int32_t offset, T& value, uint8_t handle);
+
+      // Writes count records of an array into consecutive sectors, returns the committed records
+      template <typename T>
+      uint16_t writeBatch(const T* records, uint16_t count, uint8_t handle);
+
+      // --- ASYNCHRONOUS WRITE (one pending record, see asyncStep()) ---
+      template <typename T>
+      bool writeAsync(const T& value, uint8_t handle);
+      bool writeAsync(const char* value, uint8_t handle);
+      uint8_t asyncStep();
+      uint8_t asyncState() { return _asyncState; }
    
     private:
+      template <uint16_t, uint16_t, uint8_t, uint8_t, uint16_t, uint16_t, uint8_t>
+      friend class EEPromPartition;
+#if !defined(ARDUINO)
+      // Host benchmarks (extras/host_test): access to the internal search functions
+      friend struct EEPRWL_HostProbe;
+#endif
+
+      static constexpr uint16_t pagedCount(uint16_t avail, uint16_t secSize, uint16_t page) {
+          return (avail / page) * (page / secSize) + (avail % page) / secSize;
+      }
+      void selectPartition(uint8_t handle, uint8_t ctlLen, uint16_t secSize, uint32_t maxLgcCnt, uint16_t hintInt);
+
       // --- INTERNAL STATE VARIABLES (Names adapted) ---      
+      EEPRWL_Storage* _io;
       uint8_t * _ioBuf;
+      uint8_t * _lastBuf;      // newest record payload of partition _lastHandle
       uint8_t * _buckPerm;
       uint8_t * _budgetCycles;
       uint16_t  _buckTime = 0;
       uint16_t  _tbCnt,_tbCntN, _tbCntLong, _accumulatedTime = 0;
+      bool      _ticked = false;     // oneTickPassed() is the time base, idle() does not count time
       uint16_t  _bucketStartAddr;
       ControlData* _controlCache;            
 
@@ -111,10 +236,43 @@ class EEProm_Safe_Wear_Level {
       bool _start(uint8_t handle);
       void _end();
       void _read(uint8_t ReadMode, uint8_t handle);
+      bool readCounter(uint32_t cnt, uint8_t handle);
+      bool counterSector(uint32_t cnt, uint16_t& sector);
+      bool findTime(uint32_t time, uint8_t handle);
+      uint32_t clockTime();
+      void nextCounter();
+      void bumpOverwCounter();
+      void restorePending(uint8_t handle);
+      bool migrateResume();
+      void migrateSave(bool active);
+      uint16_t streamRecords(uint16_t sector, uint16_t count, bool forward, EEPRWL_Visitor visitor, uint8_t handle, void* context, uint32_t timeTo);
 
       // ----------------------------------------------------------------------------------------------------
       // internal time management
         void updateBuckets();
+        uint16_t tokenDebit(uint8_t handle, uint16_t count);
+        void tokenRefill(uint8_t handle);
+        void tokenFill(uint8_t handle);
+        uint8_t priority(uint8_t handle);
+        void countCommitted(uint8_t handle, uint16_t count);
+      // Metadata (fixed cells or EEPRWL_META_RING)
+      uint16_t overwCounter();
+      uint16_t metaLoad(uint8_t* id, uint16_t& ovw);
+      void metaSave(const uint8_t* id, uint16_t ovw, uint16_t count);
+      void wlmSave(uint8_t states);
+      // Sector retirement (EEPRWL_SPARE_SECTORS)
+      uint16_t spareOf(uint16_t sector);
+      bool retireSector(uint16_t sector);
+      uint8_t remapLoad();
+      bool batchVerify(uint16_t sector, const uint8_t* rec, uint16_t len, uint32_t cnt, uint32_t now);
+      void batchImage(const uint8_t* rec, uint16_t len, uint32_t cnt, uint32_t now);
+      // Check word and checksum of a sector image, single bit correction (EEPRWL_ECC)
+      void sealSector();
+      bool eccRepair(SectorChk diff);
+      // Delta encoding (EEPRWL_DELTA)
+      bool _writeDelta(const uint8_t* rec, uint16_t size, uint8_t handle, bool onlyIfChanged);
+      bool _readDelta(uint8_t* rec, uint16_t size, uint8_t handle);
+      uint16_t deltaRebuild(uint8_t* rec, uint16_t size, uint8_t handle);
       // ----------------------------------------------------------------------------------------------------
 
       // Static inline function to encapsulate byte reconstruction
@@ -138,9 +296,9 @@ class EEProm_Safe_Wear_Level {
       }
 
       // 3. We calculate the addition checksum over all bytes of the ControlData cache
-      // from offset 0 up to the byte before the checksum (Byte 13: status).
+      // from offset 0 up to the byte before the status (Byte 14).
       inline uint8_t chkSum() {
-         const size_t CHECKSUM_RANGE = 13; uint8_t check = 0, check1 = 0;
+         const size_t CHECKSUM_RANGE = 14; uint8_t check = 0, check1 = 0;
          // We cast _controlCache (ControlData*) to uint8_t* to access byte by byte
          uint8_t* controlDataPtr = (uint8_t*)_controlCache;
          // 2. Calculate addition checksum
@@ -152,6 +310,48 @@ class EEProm_Safe_Wear_Level {
          return check + check1;
       }
       
+      // 4. Any non-zero byte: sector has been written since the last format
+      static inline uint8_t usedBytes(const uint8_t* buffer, uint16_t length) {
+          for (uint16_t i = 0; i < length; i++) {
+              if (buffer[i] > 0) return 1;
+          }
+          return 0;
+      }
+
+      // 5. Only 0xFF bytes: erased sector, never formatted
+      static inline uint8_t erasedBytes(const uint8_t* buffer, uint16_t length) {
+          for (uint16_t i = 0; i < length; i++) {
+              if (buffer[i] != 0xFF) return 0;
+          }
+          return 1;
+      }
+
+      // 6. Logical counter arithmetic. The counter rolls over from _maxLgcCnt to 1 (a multiple
+      // of the sector count: counter 1 is always written to sector 0). The counters of the ring
+      // then stay comparable as long as the counter covers at least two rotations; otherwise
+      // the partition stops at _maxLgcCnt (status 3) as without rollover.
+      inline bool rollover() { return _maxLgcCnt >= 2UL * _numSecs; }
+      inline bool counterFull() { return _curLgcCnt >= _maxLgcCnt && !rollover(); }
+      // Counter n records after / before c (before counter 1 without rollover: 0)
+      inline uint32_t cntNext(uint32_t c, uint32_t n) {
+          if (!rollover()) return c + n;
+          n %= _maxLgcCnt;
+          return (n <= _maxLgcCnt - c) ? c + n : n - (_maxLgcCnt - c);
+      }
+      inline uint32_t cntPrev(uint32_t c, uint32_t n) {
+          if (!rollover()) return (n < c) ? c - n : 0;
+          n %= _maxLgcCnt;
+          return (n < c) ? c - n : c + (_maxLgcCnt - n);
+      }
+      // Records from b to a (a - b)
+      inline uint32_t cntDiff(uint32_t a, uint32_t b) {
+          return (a >= b || !rollover()) ? a - b : a + (_maxLgcCnt - b);
+      }
+      // a is newer than b (serial number comparison, half the counter range)
+      inline bool cntAfter(uint32_t a, uint32_t b) {
+          return cntDiff(a, b) - 1 < (rollover() ? _maxLgcCnt / 2 : 0x7FFFFFFFUL);
+      }
+
       inline void trans16(uint16_t value, uint8_t* target_ptr) {
           union U16toB {
               uint16_t u16;
@@ -165,9 +365,32 @@ class EEProm_Safe_Wear_Level {
 
       // --- PRIVATE HELPERS (Implementation in .cpp) ---
       bool findMarginalSector(uint8_t handle, uint8_t margin);
-      uint8_t calculateCRC(const uint8_t * buffer, size_t length);
-      void formatInternal(uint8_t handle);
-      bool _write(uint8_t handle);
+      bool scanMarginalSector(uint8_t margin);
+      uint8_t readSector(uint16_t sector, uint32_t& cnt);
+      void writeHint(uint16_t sector);
+      bool restoreHead();
+      SectorChk calculateCRC(const uint8_t * buffer, size_t length);
+      void formatInternal();
+      uint16_t zeroSectors(uint16_t from, uint16_t count);
+      bool restoreStep(bool forceFormat, uint16_t& pos, uint16_t quota);
+      uint8_t layoutHash();
+      bool _write(uint8_t handle, bool onlyIfChanged = false);
+      bool writeRecord(uint8_t handle);
+      bool unchangedRecord(uint8_t handle);
+      bool deferRecord(uint8_t handle, bool onlyIfChanged);
+      bool flushSlot(uint8_t handle);
+      bool stageRecord(uint8_t handle);
+      bool _writeAsync(uint8_t handle);
+      void asyncFinish(uint8_t result);
+      uint16_t hintSlot(uint16_t sector, uint8_t* slot, uint32_t cnt);
+      uint16_t budgetDebit(uint8_t handle, uint16_t count);
+      uint16_t budgetCredit(uint8_t handle, uint16_t count);
+      uint16_t _writeBatch(const uint8_t* data, uint16_t size, uint16_t count, uint8_t handle);
+      void cacheNewest();
+      void dropNewest(uint8_t handle);
+      bool loadNewest(uint8_t handle);
+      uint16_t sectorAddr(uint16_t sector);
+      void pageGeometry();
       
       // --- INTERNAL CONSTANTS (Static, declaration adapted) ---
       // CRC_OVERHEAD, MAGIC_ID, and METADATA_SIZE remain for readability.
@@ -175,12 +398,113 @@ class EEProm_Safe_Wear_Level {
       uint8_t* _ramStart;
       uint16_t _ioBufSize;
       uint16_t _secSize; 
+      uint16_t _hintInt;
+      uint16_t _pageBase;
+      uint8_t  _secPerPage;
       uint32_t _maxLgcCnt;
       uint8_t  _handle;
       uint8_t  _handle1;
+      uint8_t  _lastHandle;
       uint8_t  _usedSector;
+      EEPRWL_Clock _clock;
+      uint16_t _timeRes;
+
+#if EEPRWL_RECORD_CACHE > 0
+      // Newest record per partition (EEPRWL_RECORD_CACHE)
+      uint8_t  _recBuf[EEPRWL_RECORD_CACHE][EEPRWL_RECORD_CACHE_SIZE];
+      uint32_t _recCnt[EEPRWL_RECORD_CACHE];    // logical counter, 0 = empty
+      uint16_t _recNext[EEPRWL_RECORD_CACHE];   // _nextPhSec behind the record
+#endif
+
+#if EEPRWL_WRITE_BACK > 0
+      // Write-back slots (EEPRWL_WRITE_BACK)
+      uint8_t  _wbBuf[EEPRWL_WRITE_BACK][EEPRWL_WRITE_BACK_SIZE];
+      uint32_t _wbTime[EEPRWL_WRITE_BACK];      // millis() of the first unsaved write
+      uint8_t  _wbMode;                         // bit per handle: write-back enabled
+      uint8_t  _wbDirty;                        // bit per handle: slot not yet written
+      bool     _wbForce;                        // power-fail flush: no budget check
+#endif
+
+#if EEPRWL_LAZY_INIT > 0
+      // Deferred restore (EEPRWL_LAZY_INIT)
+      uint16_t _restoring;                      // bit per handle: restore pending
+      uint16_t _rstPos;                         // zero-fill position of _rstHandle (restoreStep())
+      uint8_t  _rstHandle;
+#endif
+
+#if EEPRWL_TOKEN_BUCKETS > 0
+      // Token buckets (EEPRWL_TOKEN_BUCKETS)
+      uint32_t _tkFill[EEPRWL_TOKEN_BUCKETS];   // tokens in 1/256 write
+      uint32_t _tkStamp[EEPRWL_TOKEN_BUCKETS];  // _tkClock of the last refill
+      uint16_t _tkRate[EEPRWL_TOKEN_BUCKETS];   // refill in 1/16 write per hour
+      uint16_t _tkBurst[EEPRWL_TOKEN_BUCKETS];  // depth in writes
+      uint32_t _tkClock;                        // steps of TOKEN_STEP seconds
+      uint32_t _tkRest;                         // time of the current step (s / ms)
+      uint32_t _tkMillis;                       // idle(): millis() of the last call
+#endif
+
+#if EEPRWL_PRIORITY_POOL > 0
+      // Priority classes (EEPRWL_PRIORITY_POOL)
+      uint32_t _prioMap;                        // 2 bits per handle 0..15: class
+      uint32_t _prioShed[3];                    // writes rejected by the budget, per class
+      uint32_t _prioDone[3];                    // writes committed, per class
+      uint16_t _prioPool;                       // reserve writes left in this hour
+#endif
+
+#if EEPRWL_META_RING > 0
+      // WLM ring (EEPRWL_META_RING)
+      uint8_t  _wlmStates;                      // bit per bucket: level high
+      uint8_t  _wlmSeq;                         // sequence of the newest record
+#endif
+
+#if EEPRWL_SPARE_SECTORS > 0
+      // Remap table of _remapHandle (EEPRWL_SPARE_SECTORS)
+      uint16_t _remap[EEPRWL_SPARE_SECTORS];    // ring sector per spare, >= _numSecs: free
+      uint8_t  _remapHandle;                    // 0xFF = not loaded
+#endif
+
+#if EEPRWL_ECC > 0
+      // Sector ECC (EEPRWL_ECC)
+      uint32_t _eccFixed;                       // reads corrected
+      uint32_t _eccLost;                        // corrupt reads, not correctable
+#endif
+
+#if EEPRWL_DELTA > 0
+      // Delta encoding (EEPRWL_DELTA)
+      uint8_t  _dtBuf[EEPRWL_DELTA][EEPRWL_DELTA_SIZE];  // newest record: reference of the next delta
+      uint8_t  _dtSize[EEPRWL_DELTA];           // record size of _dtBuf
+      uint8_t  _dtEvery[EEPRWL_DELTA];          // keyframe interval in records
+      uint16_t _dtCount[EEPRWL_DELTA];          // records since the keyframe
+      uint8_t  _dtMode;                         // bit per handle: delta encoding enabled
+      uint8_t  _dtKnown;                        // bit per handle: _dtBuf holds the newest record
+#endif
+
+      // Asynchronous write job (sector image, address, optional head hint)
+      uint8_t* _asyncBuf;
+      uint16_t _asyncBufSize;
+      uint16_t _asyncAddr;
+      uint16_t _asyncLen;
+      uint16_t _asyncPos;
+      uint16_t _asyncHintAddr;   // 0 = no hint due
+      uint8_t  _asyncHint[3];
+      uint8_t  _asyncHandle;
+      uint8_t  _asyncPhase;
+      volatile uint8_t _asyncState;
+
+      // Migration job: next source counter, target counter at the job start (persistent copy:
+      // EEPRWL_MIGRATE_JOB, progress = target records since _migBase)
+      uint32_t _migNext;
+      uint32_t _migBase;
+      uint16_t _migLeft;         // 0 = no job
+      uint8_t  _migSrc;
+      uint8_t  _migTgt;
+      bool     _migResume;       // job loaded from the EEPROM, progress not yet applied
 };
 
+#if defined(EEPRWL_ASYNC_ISR)
+extern EEProm_Safe_Wear_Level* EEPRWL_asyncOwner;
+#endif
+
 // ----------------------------------------------------------------------------------------------------
 // --- TEMPLATE IMPLEMENTATIONS (Names adapted) ---
 // ----------------------------------------------------------------------------------------------------
@@ -212,14 +536,20 @@ class EEProm_Safe_Wear_Level {
  *
  */
 template <typename T>
-bool EEProm_Safe_Wear_Level::write(const T& value, uint8_t handle) {     
+bool EEProm_Safe_Wear_Level::write(const T& value, uint8_t handle, bool onlyIfChanged) {     
       check_and_init
       bool success;
       // Consistency check
-      if (_numSecs < 1 || _curLgcCnt >= _maxLgcCnt) {
+      if (_numSecs < 1 || counterFull()) {
            success = 0;
-           if(_curLgcCnt >= _maxLgcCnt) _status = 3;
+           if(counterFull()) _status = 3;
       } else success = 1;
+#if EEPRWL_DELTA > 0
+      // Delta partition: changed byte runs or a keyframe
+      if (success == 1 && handle < EEPRWL_DELTA && (_dtMode & (1 << handle))) {
+         success = _writeDelta((const uint8_t *)&value, sizeof(T), handle, onlyIfChanged);
+      } else
+#endif
       if (success == 1) {
          if (sizeof(T) > _pldSize) _status = 2;
 
@@ -230,7 +560,47 @@ bool EEProm_Safe_Wear_Level::write(const T& value, uint8_t handle) {
               if(i < sizeof(T)) _ioBuf[i] = valuePtr[i];
               else _ioBuf[i] = 0;
          }
-         success = _write(handle);
+         success = _write(handle, onlyIfChanged);
+      }
+      return_and_checksum success;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+template <typename T>
+uint16_t EEProm_Safe_Wear_Level::writeBatch(const T* records, uint16_t count, uint8_t handle) {
+      check_and_init
+      uint16_t committed = 0;
+      // Consistency check
+      if (_numSecs < 1 || counterFull()) {
+           if(counterFull()) _status = 3;
+      } else committed = _writeBatch((const uint8_t *)records, sizeof(T), count, handle);
+      return_and_checksum committed;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+template <typename T>
+bool EEProm_Safe_Wear_Level::writeAsync(const T& value, uint8_t handle) {
+      check_and_init
+      bool success;
+      // Consistency check, one pending job at a time
+      if (_numSecs < 1 || counterFull() || _asyncState == EEPRWL_ASYNC_BUSY) {
+           success = 0;
+           if(counterFull()) _status = 3;
+           else if(_asyncState == EEPRWL_ASYNC_BUSY) _status = 13;
+      } else success = 1;
+      if (success == 1) {
+         if (sizeof(T) > _pldSize) _status = 2;
+
+         uint8_t * valuePtr = (uint8_t *)&value;
+         uint16_t i;
+
+         for(i = 0; i < _pldSize; i++) {
+              if(i < sizeof(T)) _ioBuf[i] = valuePtr[i];
+              else _ioBuf[i] = 0;
+         }
+         success = _writeAsync(handle);
       }
       return_and_checksum success;
 }
@@ -240,6 +610,14 @@ bool EEProm_Safe_Wear_Level::write(const T& value, uint8_t handle) {
 template <typename T>
 bool EEProm_Safe_Wear_Level::read(uint8_t ReadMode, T& value, uint8_t handle, size_t maxSize) {
     check_and_init
+
+#if EEPRWL_DELTA > 0
+    // Delta partition: the newest record is rebuilt from the keyframe and the deltas
+    if (ReadMode == 0 && handle < EEPRWL_DELTA && (_dtMode & (1 << handle))) {
+      bool rebuilt = _readDelta((uint8_t *)&value, sizeof(T), handle);
+      return_and_checksum rebuilt;
+    }
+#endif
       
     _read(ReadMode, handle);
     uint8_t success = _ioBuf[_secSize - 1];
@@ -261,5 +639,33 @@ bool EEProm_Safe_Wear_Level::read(uint8_t ReadMode, T& value, uint8_t handle, si
 
 // ----------------------------------------------------------------------------------------------------
 
+template <typename T>
+bool EEProm_Safe_Wear_Level::readByCounter(uint32_t counter, T& value, uint8_t handle) {
+    check_and_init
+
+    bool success = readCounter(counter, handle);
+    if (success) memcpy((uint8_t *)&value, _ioBuf, (sizeof(T) < _pldSize) ? sizeof(T) : _pldSize);
+
+    return_and_checksum success;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+template <typename T>
+bool EEProm_Safe_Wear_Level::readRelative(int32_t offset, T& value, uint8_t handle) {
+    check_and_init
+
+    // offset 0: current record, -k: k records older (after write(): the newest record)
+    uint32_t counter = (offset < 0) ? cntPrev(_curLgcCnt, -(uint32_t)offset) : cntNext(_curLgcCnt, offset);
+    bool success = readCounter(counter, handle);
+    if (success) memcpy((uint8_t *)&value, _ioBuf, (sizeof(T) < _pldSize) ? sizeof(T) : _pldSize);
+
+    return_and_checksum success;
+}
+
+// ----------------------------------------------------------------------------------------------------
+
+#include "EEProm_Safe_Wear_Level_Partition.h"
+
 #endif // EEPROM_WEAR_LEVEL_H
 // END OF CODE
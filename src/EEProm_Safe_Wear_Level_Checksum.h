@@ -0,0 +1,178 @@
+#ifndef EEPROM_SAFE_WEAR_LEVEL_CHECKSUM_H
+#define EEPROM_SAFE_WEAR_LEVEL_CHECKSUM_H
+
+// -----------------------------------------------------------
+// SECTOR CHECKSUM ENGINES
+// -----------------------------------------------------------
+// The engine is selected at compile time with EEPRWL_CHECKSUM
+// (see EEProm_Safe_Wear_Level_Macros.h). All engines are plain
+// inline functions, so unused engines (and their tables) do not
+// occupy Flash memory.
+//
+// +----------------------+------+--------------------------------------+
+// | Engine               | Size | Note                                 |
+// +----------------------+------+--------------------------------------+
+// | EEPRWL_CRC8          | 1 B  | bitwise, poly 0x07, smallest code    |
+// | EEPRWL_CRC8_NIBBLE   | 1 B  | same result, 16 byte table (default) |
+// | EEPRWL_CRC8_TABLE    | 1 B  | same result, 256 byte PROGMEM table  |
+// | EEPRWL_CRC16         | 2 B  | CRC-16/CCITT (reflected, poly 0x1021)|
+// | EEPRWL_FLETCHER16    | 2 B  | Fletcher-16 (mod 255), fastest 2 B   |
+// +----------------------+------+--------------------------------------+
+// The three CRC-8 engines produce identical checksums and share
+// one EEPROM format. Switching to or from a 2 byte engine changes
+// the sector layout and reformats the partitions (Magic ID).
+
+#define EEPRWL_CRC8          0
+#define EEPRWL_CRC8_NIBBLE   1
+#define EEPRWL_CRC8_TABLE    2
+#define EEPRWL_CRC16         3
+#define EEPRWL_FLETCHER16    4
+
+// 1. CRC-8, bitwise (8 iterations per byte)
+static inline uint8_t eeprwlCrc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0x00;
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t j = 0; j < 8; j++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+// 2. CRC-8, two table lookups per byte (upper / lower nibble)
+static const uint8_t EEPRWL_CRC8_NIB[16] PROGMEM = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D
+};
+
+static inline uint8_t eeprwlCrc8Nibble(const uint8_t* data, size_t length) {
+    uint8_t crc = 0x00;
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        crc = (crc << 4) ^ pgm_read_byte(&EEPRWL_CRC8_NIB[crc >> 4]);
+        crc = (crc << 4) ^ pgm_read_byte(&EEPRWL_CRC8_NIB[crc >> 4]);
+    }
+
+    return crc;
+}
+
+// 3. CRC-8, one table lookup per byte
+static const uint8_t EEPRWL_CRC8_TAB[256] PROGMEM = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+    0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65, 0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
+    0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+    0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
+    0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2, 0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
+    0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+    0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
+    0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42, 0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
+    0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+    0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
+    0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C, 0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
+    0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+    0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
+    0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B, 0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
+    0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+    0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3
+};
+
+static inline uint8_t eeprwlCrc8Table(const uint8_t* data, size_t length) {
+    uint8_t crc = 0x00;
+
+    for (size_t i = 0; i < length; i++) {
+        crc = pgm_read_byte(&EEPRWL_CRC8_TAB[crc ^ data[i]]);
+    }
+
+    return crc;
+}
+
+// 4. CRC-16/CCITT, reflected (0x8408), table-free byte step (as avr-libc _crc_ccitt_update)
+static inline uint16_t eeprwlCrc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0x0000;
+
+    for (size_t i = 0; i < length; i++) {
+        uint8_t d = data[i] ^ (uint8_t)crc;
+        d ^= d << 4;
+        crc = (((uint16_t)d << 8) | (crc >> 8)) ^ (uint8_t)(d >> 4) ^ ((uint16_t)d << 3);
+    }
+
+    return crc;
+}
+
+// 5. Fletcher-16: two running sums modulo 255
+static inline uint16_t eeprwlFletcher16(const uint8_t* data, size_t length) {
+    uint16_t sum1 = 0, sum2 = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        sum1 += data[i]; if (sum1 >= 255) sum1 -= 255;
+        sum2 += sum1;    if (sum2 >= 255) sum2 -= 255;
+    }
+
+    return (sum2 << 8) | sum1;
+}
+
+// -----------------------------------------------------------
+// SEC-DED CODE (EEPRWL_ECC)
+// -----------------------------------------------------------
+// Extended Hamming code over the data bytes of a sector (payload,
+// counter, timestamp; max. 511 bytes), check word of 2 bytes:
+// bits 0-13 = XOR of the columns of all set data bits, bit 14 =
+// parity of all data and check bits. Data bit k of byte j has the
+// column (j << 5) | (2k + 3): odd and > 1, so it never equals the
+// column of a check bit (a power of 2). Two nibble tables give the
+// column bits of a byte, the byte parity adds (j << 5).
+
+// Low bits of the columns: XOR of (2k + 3) over the set bits k of a nibble
+static const uint8_t EEPRWL_ECC_LO[16] PROGMEM = {
+    0x00, 0x03, 0x05, 0x06, 0x07, 0x04, 0x02, 0x01, 0x09, 0x0A, 0x0C, 0x0F, 0x0E, 0x0D, 0x0B, 0x08
+};
+static const uint8_t EEPRWL_ECC_HI[16] PROGMEM = {
+    0x00, 0x0B, 0x0D, 0x06, 0x0F, 0x04, 0x02, 0x09, 0x11, 0x1A, 0x1C, 0x17, 0x1E, 0x15, 0x13, 0x18
+};
+
+// Parity of the set bits (1 = odd)
+static inline uint8_t eeprwlParity(uint16_t v) {
+    v ^= v >> 8; v ^= v >> 4; v ^= v >> 2; v ^= v >> 1;
+    return v & 1;
+}
+
+// Check word of the data bytes
+static inline uint16_t eeprwlEcc(const uint8_t* data, size_t length) {
+    uint16_t syn = 0;
+    uint8_t par = 0;
+
+    for (size_t j = 0; j < length; j++) {
+        uint8_t b = data[j];
+        syn ^= pgm_read_byte(&EEPRWL_ECC_LO[b & 0x0F]) ^ pgm_read_byte(&EEPRWL_ECC_HI[b >> 4]);
+        if (eeprwlParity(b)) { syn ^= (uint16_t)j << 5; par ^= 1; }
+    }
+
+    return syn | ((uint16_t)(par ^ eeprwlParity(syn)) << 14);
+}
+
+// Checks the data bytes against the stored check word. A single bit error is corrected
+// in place (data bit, or the check word is replaced). Returns 0: no error, 1: corrected,
+// 2: uncorrectable (two bit errors, or a syndrome outside the data).
+static inline uint8_t eeprwlEccCorrect(uint8_t* data, size_t length, uint16_t& check) {
+    uint16_t calc = eeprwlEcc(data, length);
+    uint16_t diff = calc ^ check;
+    uint16_t syn = diff & 0x3FFF;
+
+    if (diff == 0) return 0;
+    // Even number of flipped bits
+    if (!eeprwlParity(diff)) return 2;
+
+    // Overall parity bit, unused bit 15 or a check bit (power of 2)
+    if ((syn & (syn - 1)) == 0) { check = calc; return 1; }
+
+    uint8_t t = syn & 0x1F;
+    uint16_t j = syn >> 5;
+    if (!(t & 1) || t < 3 || t > 17 || j >= length) return 2;
+    data[j] ^= 1 << ((t - 3) >> 1);
+    return 1;
+}
+
+#endif // EEPROM_SAFE_WEAR_LEVEL_CHECKSUM_H
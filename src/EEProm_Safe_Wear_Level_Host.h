@@ -0,0 +1,29 @@
+#ifndef EEPROM_SAFE_WEAR_LEVEL_HOST_H
+#define EEPROM_SAFE_WEAR_LEVEL_HOST_H
+
+// -----------------------------------------------------------
+// HOST BUILD (without Arduino core)
+// -----------------------------------------------------------
+// Provides the few core functions used by the library, so it can
+// be compiled and tested on a PC (e.g. Linux, g++) together with
+// EEPRWL_RamStorage. Interrupt locking has no meaning there.
+//
+// millis() / micros(): weak defaults (steady clock) in the .cpp,
+//           a test can define its own to simulate time.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+unsigned long millis();
+unsigned long micros();
+
+static inline void cli() {}
+static inline void sei() {}
+
+#ifndef PROGMEM
+     #define PROGMEM
+     #define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#endif
+
+#endif // EEPROM_SAFE_WEAR_LEVEL_HOST_H
@@ -0,0 +1,119 @@
+#ifndef EEPROM_SAFE_WEAR_LEVEL_I2C_H
+#define EEPROM_SAFE_WEAR_LEVEL_I2C_H
+
+// -----------------------------------------------------------
+// I2C STORAGE BACKENDS (optional, include in the sketch)
+// -----------------------------------------------------------
+// EEPRWL_I2CEEPROM : 24LC32 ... 24LC512 (2 address bytes, page write)
+// EEPRWL_I2CFRAM   : MB85RC / FM24 FRAM (no pages, no write cycle)
+//
+// Usage:
+//   #include <EEProm_Safe_Wear_Level.h>
+//   #include <EEProm_Safe_Wear_Level_I2C.h>
+//   EEPRWL_I2CEEPROM extEEPROM(0x50, 4096, 32);
+//   EEProm_Safe_Wear_Level EEPRWL_Ext(PartitionsData.data, extEEPROM);
+//   setup(): Wire.begin(); ...
+//
+// Block transfers use one bus transaction per page (or per
+// Wire buffer). After a page write the EEPROM is polled until it
+// acknowledges again (end of the internal write cycle).
+//
+// REQUIREMENT: '#define EEPRWL_LOCK EEPRWL_LOCK_SHORT' in
+// EEProm_Safe_Wear_Level_Macros.h. Wire needs the TWI interrupt
+// and the ack polling needs millis(); with EEPRWL_LOCK_FULL the
+// API calls run with interrupts disabled and the first bus access
+// would hang.
+
+#include <Wire.h>
+#include "EEProm_Safe_Wear_Level_Storage.h"
+#include "EEProm_Safe_Wear_Level_Macros.h"
+
+#if EEPRWL_LOCK == EEPRWL_LOCK_FULL
+  #error "I2C backends need '#define EEPRWL_LOCK EEPRWL_LOCK_SHORT' in EEProm_Safe_Wear_Level_Macros.h"
+#endif
+
+// Usable data bytes per Wire transaction (Wire buffer minus 2 address bytes)
+#ifndef EEPRWL_I2C_CHUNK
+     #define EEPRWL_I2C_CHUNK 30
+#endif
+// Maximum write cycle of the EEPROM in ms (ack polling timeout)
+#ifndef EEPRWL_I2C_WRITE_MS
+     #define EEPRWL_I2C_WRITE_MS 10
+#endif
+
+class EEPRWL_I2CEEPROM : public EEPRWL_Storage {
+    public:
+      // pageSize = 0: no page boundaries and no write cycle (FRAM)
+      EEPRWL_I2CEEPROM(uint8_t deviceAddr = 0x50, uint16_t size = 4096, uint8_t pageSize = 32, TwoWire& wire = Wire)
+          : _dev(deviceAddr), _size(size), _page(pageSize), _wire(wire) {}
+
+      uint8_t read(uint16_t addr) {
+          uint8_t value = 0xFF;
+          readBlock(addr, &value, 1);
+          return value;
+      }
+
+      void write(uint16_t addr, uint8_t value) {
+          writeBlock(addr, &value, 1);
+      }
+
+      uint16_t length() { return _size; }
+      uint16_t pageSize() { return _page; }
+
+      void readBlock(uint16_t addr, uint8_t* buffer, uint16_t len) {
+          while (len > 0) {
+              uint8_t n = (len > EEPRWL_I2C_CHUNK) ? EEPRWL_I2C_CHUNK : len;
+              setAddress(addr);
+              _wire.endTransmission();
+              _wire.requestFrom(_dev, n);
+              for (uint8_t i = 0; i < n; i++) buffer[i] = _wire.available() ? _wire.read() : 0xFF;
+              addr += n; buffer += n; len -= n;
+          }
+      }
+
+      void writeBlock(uint16_t addr, const uint8_t* buffer, uint16_t len) {
+          while (len > 0) {
+              // never cross a page boundary within one write cycle
+              uint16_t n = (len > EEPRWL_I2C_CHUNK) ? EEPRWL_I2C_CHUNK : len;
+              if (_page > 0 && n > _page - (addr % _page)) n = _page - (addr % _page);
+
+              setAddress(addr);
+              _wire.write(buffer, n);
+              _wire.endTransmission();
+              waitReady();
+              addr += n; buffer += n; len -= n;
+          }
+      }
+
+    private:
+      uint8_t  _dev;
+      uint16_t _size;
+      uint8_t  _page;
+      TwoWire& _wire;
+
+      void setAddress(uint16_t addr) {
+          _wire.beginTransmission(_dev);
+          _wire.write((uint8_t)(addr >> 8));
+          _wire.write((uint8_t)addr);
+      }
+
+      // Acknowledge polling: the EEPROM does not answer during the write cycle
+      void waitReady() {
+          if (_page == 0) return;
+          uint32_t t = millis();
+          do {
+              _wire.beginTransmission(_dev);
+              if (_wire.endTransmission() == 0) return;
+          } while (millis() - t < EEPRWL_I2C_WRITE_MS);
+      }
+};
+
+// ----------------------------------------------------------------------------------------------------
+
+class EEPRWL_I2CFRAM : public EEPRWL_I2CEEPROM {
+    public:
+      EEPRWL_I2CFRAM(uint8_t deviceAddr = 0x50, uint16_t size = 32768, TwoWire& wire = Wire)
+          : EEPRWL_I2CEEPROM(deviceAddr, size, 0, wire) {}
+};
+
+#endif // EEPROM_SAFE_WEAR_LEVEL_I2C_H
@@ -17,8 +17,11 @@
 #define _startAddr          (*_controlCache).startAddr
 #define _pldSize            (*_controlCache).pldSize
 #define _numSecs            (*_controlCache).numSecs
-#define _cntLen             (*_controlCache).cntLen
+#define _cntCfg             (*_controlCache).cntLen            // counter length | timestamp width << 4
+#define _cntLen             ((*_controlCache).cntLen & 0x0F)   // counter bytes
+#define _tsLen              ((*_controlCache).cntLen >> 4)     // timestamp bytes (0 = none)
 #define _buckCyc            (*_controlCache).buckCyc
+#define _epoch              (*_controlCache).epoch             // format epoch (lazy format)
 #define _status             (*_controlCache).status
 #define _checksum           (*_controlCache).checksum
 #define CONTROL_STRUCT_SIZE 16
@@ -37,8 +40,9 @@ typedef struct __attribute__((packed)) {
     uint16_t startAddr;      // Offset 6 (2 B)
     uint16_t numSecs;        // Offset 8 (2 B) 
     uint8_t  pldSize;        // Offset 10 (1 B)
-    uint8_t  cntLen;         // Offset 11 (1 B)
-    uint16_t buckCyc;        // Offset 12 (2 B)
+    uint8_t  cntLen;         // Offset 11 (1 B) bits 0-3: counter, bits 4-7: timestamp bytes
+    uint8_t  buckCyc;        // Offset 12 (1 B)
+    uint8_t  epoch;          // Offset 13 (1 B) format epoch, mixed into the sector checksums
     uint8_t  status;         // Offset 14 (1 B)
     uint8_t checksum;        // Offset 15 (1 B)
 } ControlData; 
@@ -46,19 +50,324 @@ typedef struct __attribute__((packed)) {
 
 // END OF CODE
 
-#define e_w EEPROM.write
-#define e_r EEPROM.read
+// -----------------------------------------------------------
+// 4. STORAGE ACCESS AND DIAGNOSTICS (optional)
+// -----------------------------------------------------------
+// Uncomment to count every EEPROM byte access of the library in
+// EEPRWL_ioReads / EEPRWL_ioWrites (used by the benchmark sketches).
+// The bytes written to metadata (partition header, head hints, WLM
+// area, migration job) are also counted in EEPRWL_metaWrites.
+//#define EEPRWL_IO_STATS
 
-#if defined(ESP8266) || defined(ESP32)
-     #define e_c EEPROM.commit()
+// Storage access through the backend _io (EEProm_Safe_Wear_Level_Storage.h)
+#ifdef EEPRWL_IO_STATS
+     extern uint32_t EEPRWL_ioReads;
+     extern uint32_t EEPRWL_ioWrites;
+     extern uint32_t EEPRWL_metaWrites;
+     #define e_w(a, v) (EEPRWL_ioWrites++, _io->write(a, v))
+     #define e_r(a) (EEPRWL_ioReads++, _io->read(a))
+     #define e_wb(a, b, n) (EEPRWL_ioWrites += (n), _io->writeBlock(a, b, n))
+     #define e_rb(a, b, n) (EEPRWL_ioReads += (n), _io->readBlock(a, b, n))
+     #define e_mw(a, v) (EEPRWL_metaWrites++, e_w(a, v))
+     #define e_mwb(a, b, n) (EEPRWL_metaWrites += (n), e_wb(a, b, n))
 #else
-     #define e_c do {} while(0)
+     #define e_w(a, v) _io->write(a, v)
+     #define e_r(a) _io->read(a)
+     #define e_wb(a, b, n) _io->writeBlock(a, b, n)
+     #define e_rb(a, b, n) _io->readBlock(a, b, n)
+     #define e_mw(a, v) e_w(a, v)
+     #define e_mwb(a, b, n) e_wb(a, b, n)
 #endif
+#define e_c _io->commit()
+#define e_len _io->length()
 
-#endif // EEPROM_SAFE_WEAR_LEVEL_MACROS_H
+// -----------------------------------------------------------
+// 5. SECTOR CHECKSUM ENGINE
+// -----------------------------------------------------------
+// EEPRWL_CRC8 / EEPRWL_CRC8_NIBBLE / EEPRWL_CRC8_TABLE (1 byte)
+// EEPRWL_CRC16 / EEPRWL_FLETCHER16 (2 bytes, larger payloads)
+// See EEProm_Safe_Wear_Level_Checksum.h
+#include "EEProm_Safe_Wear_Level_Checksum.h"
+#ifndef EEPRWL_CHECKSUM
+     #define EEPRWL_CHECKSUM EEPRWL_CRC8_NIBBLE
+#endif
+
+// CRC_LEN: checksum bytes per sector, CRC_FORMAT: part of the Magic ID
+#if EEPRWL_CHECKSUM == EEPRWL_CRC16 || EEPRWL_CHECKSUM == EEPRWL_FLETCHER16
+     #define CRC_LEN 2
+     #define CRC_FORMAT (EEPRWL_CHECKSUM - 2)
+     typedef uint16_t SectorChk;
+#else
+     #define CRC_LEN 1
+     #define CRC_FORMAT 0
+     typedef uint8_t SectorChk;
+#endif
+
+// -----------------------------------------------------------
+// 6. ASYNCHRONOUS WRITE ENGINE
+// -----------------------------------------------------------
+// writeAsync() stages a record, asyncStep() writes it byte by byte
+// whenever the storage is ready. Uncomment to drive the engine by
+// the EEPROM-ready interrupt of the internal AVR EEPROM instead of
+// calling asyncStep() in loop().
+//#define EEPRWL_ASYNC_ISR
+
+// asyncState() / asyncStep()
+#define EEPRWL_ASYNC_IDLE    0   // no job since start
+#define EEPRWL_ASYNC_BUSY    1   // job pending
+#define EEPRWL_ASYNC_DONE    2   // last job written and verified
+#define EEPRWL_ASYNC_FAILED  3   // last job: verify failed
+
+// -----------------------------------------------------------
+// 7. INTERRUPT LOCKING
+// -----------------------------------------------------------
+// EEPRWL_LOCK_FULL : interrupts are disabled for the whole API call,
+//                    including the EEPROM I/O (default)
+// EEPRWL_LOCK_SHORT: only the check and the update of the control
+//                    block (checksum) are atomic, the EEPROM I/O runs
+//                    with interrupts enabled. API functions must not
+//                    be called from interrupt routines in this mode.
+#define EEPRWL_LOCK_FULL   0
+#define EEPRWL_LOCK_SHORT  1
+#ifndef EEPRWL_LOCK
+     #define EEPRWL_LOCK EEPRWL_LOCK_FULL
+#endif
+
+// Uncomment to measure the longest interrupt-off window of the
+// library in EEPRWL_irqOffMax (microseconds, reset it to 0 before
+// a call to measure a single API call).
+//#define EEPRWL_IRQ_STATS
+#ifdef EEPRWL_IRQ_STATS
+     extern uint32_t EEPRWL_irqOffMax;
+#endif
+
+// -----------------------------------------------------------
+// 8. PARTITION LAYOUT
+// -----------------------------------------------------------
+// Head hints: every sectors/4 records the head sector is stored in one of 4 slots
+// of the metadata, config() then restores the head from the newest slot. The hint
+// slots change the layout (partitions of the same library without hints are
+// formatted once), so they are off by default.
+//#define EEPRWL_HEAD_HINTS 1
+#ifndef EEPRWL_HEAD_HINTS
+     #define EEPRWL_HEAD_HINTS 0
+#endif
+
+// Meta Data (size: magic-id(1) + config-hash(1) + Overwrite-counter(2) [+ head hints(4x3)]),
+// with EEPRWL_META_RING the first 4 bytes are replaced by the metadata ring,
+// with EEPRWL_SPARE_SECTORS the remap table (2 bytes per spare) follows the hints:
+#define HINT_SLOTS  4
+#define HINT_ADDR  ((EEPRWL_META_RING > 0) ? META_REC * EEPRWL_META_RING : 4)
+#define REMAP_ADDR  (HINT_ADDR + ((EEPRWL_HEAD_HINTS > 0) ? 3 * HINT_SLOTS : 0))
+#define METADATA_SIZE  (REMAP_ADDR + 2 * EEPRWL_SPARE_SECTORS)
+// WLM bucket area at the end of the internal EEPROM (8 permanent buckets + 1)
+#define WLM_SIZE  9
 
+// EEPROM size for the compile-time layout check of EEPromPartition
+// (WLM bucket area at the end). 0 = unknown, no check.
+#ifndef EEPRWL_MEM_SIZE
+  #if defined(E2END)
+     #define EEPRWL_MEM_SIZE (E2END + 1)
+  #else
+     #define EEPRWL_MEM_SIZE 0
+  #endif
+#endif
+
+// -----------------------------------------------------------
+// 9. RECORD CACHE
+// -----------------------------------------------------------
+// Newest record of the partitions with handle 0 .. EEPRWL_RECORD_CACHE-1
+// in RAM: read(0) after a handle switch and write(..., onlyIfChanged) need
+// no EEPROM access. RAM: EEPRWL_RECORD_CACHE * (EEPRWL_RECORD_CACHE_SIZE + 6)
+// bytes. 0 = off (no RAM).
+#ifndef EEPRWL_RECORD_CACHE
+     #define EEPRWL_RECORD_CACHE 0
+#endif
+// Largest cached payload, partitions with larger payloads are not cached
+#ifndef EEPRWL_RECORD_CACHE_SIZE
+     #define EEPRWL_RECORD_CACHE_SIZE 8
+#endif
+
+// -----------------------------------------------------------
+// 10. WRITE-BACK
 // -----------------------------------------------------------
-// Other
+// RAM slot per partition (handles 0 .. EEPRWL_WRITE_BACK-1, max. 8):
+// with setWriteBack() a write() only updates the slot, flush() writes
+// the latest value as one sector. RAM: EEPRWL_WRITE_BACK *
+// (EEPRWL_WRITE_BACK_SIZE + 4) + 3 bytes. 0 = off (no RAM).
+#ifndef EEPRWL_WRITE_BACK
+     #define EEPRWL_WRITE_BACK 0
+#endif
+#if EEPRWL_WRITE_BACK > 8
+     #error "EEPRWL_WRITE_BACK: max. 8 partitions"
+#endif
+// Largest payload of a write-back partition
+#ifndef EEPRWL_WRITE_BACK_SIZE
+     #define EEPRWL_WRITE_BACK_SIZE 8
+#endif
+// idle(): flush of the slots that are dirty for at least this time [ms]
+#ifndef EEPRWL_WRITE_BACK_MS
+     #define EEPRWL_WRITE_BACK_MS 10000
+#endif
+
+// -----------------------------------------------------------
+// 11. LAZY FORMAT
+// -----------------------------------------------------------
+// A format of an unchanged partition layout (initialize() with
+// forceFormat) only starts a new format epoch: the epoch is mixed
+// into the sector checksums, the sectors of the earlier epochs are
+// read as empty. Only the metadata is written. Every
+// (EEPRWL_LAZY_FORMAT + 1)th format, a new layout and the first
+// format zero-fill the sectors. 0 = always zero-fill. Max. 7.
+#ifndef EEPRWL_LAZY_FORMAT
+     #define EEPRWL_LAZY_FORMAT 7
+#endif
+#if EEPRWL_LAZY_FORMAT > 7
+     #error "EEPRWL_LAZY_FORMAT: max. 7"
+#endif
+
 // -----------------------------------------------------------
-#define maxCapacity (uint32_t)(1UL << (_cntLen * 8)) - 1
+// 12. INCREMENTAL MIGRATION
+// -----------------------------------------------------------
+// migrateBegin() / migrateStep(): records copied per idle() call.
+#ifndef EEPRWL_MIGRATE_STEP
+     #define EEPRWL_MIGRATE_STEP 4
+#endif
+// 1 = the migration job is stored in 13 bytes below the WLM bucket
+// area and resumed after a reboot. Partitions are limited to the
+// space below it (a partition up to the WLM area shrinks and is
+// reformatted once). 0 = job only in RAM.
+#ifndef EEPRWL_MIGRATE_JOB
+     #define EEPRWL_MIGRATE_JOB 0
+#endif
+#if EEPRWL_MIGRATE_JOB > 0
+     #define MIGRATE_JOB_SIZE 13
+#else
+     #define MIGRATE_JOB_SIZE 0
+#endif
+
+// -----------------------------------------------------------
+// 13. DEFERRED RESTORE
+// -----------------------------------------------------------
+// config() only sets up the geometry (no EEPROM access) and marks
+// the partition (handles 0..15) as restoring. idle() restores one
+// partition per call; the zero-fill of a format runs in slices of
+// EEPRWL_LAZY_INIT sectors. The first access to a restoring
+// partition completes its restore. 0 = config() restores at once.
+#ifndef EEPRWL_LAZY_INIT
+     #define EEPRWL_LAZY_INIT 0
+#endif
+
+// -----------------------------------------------------------
+// 14. TOKEN BUCKETS
+// -----------------------------------------------------------
+// Own write budget for the partitions with handle 0 ..
+// EEPRWL_TOKEN_BUCKETS-1: refill rate in 1/16 write per hour, burst
+// depth in writes (setWriteRate()), exact accounting in 1/256 write.
+// The tick functions only advance a clock (16 steps per hour), the
+// refill is calculated on access. RAM: EEPRWL_TOKEN_BUCKETS * 12 + 12
+// bytes. 0 = the 8 shared write credit buckets (handle & 7).
+#ifndef EEPRWL_TOKEN_BUCKETS
+     #define EEPRWL_TOKEN_BUCKETS 0
+#endif
+// Clock step of the token buckets [s]
+#define TOKEN_STEP  225
+
+// -----------------------------------------------------------
+// 15. PRIORITY CLASSES
+// -----------------------------------------------------------
+// Write priority of the partitions with handle 0..15 (setPriority()):
+// low priority writes are shed while the write budget is below a
+// quarter, critical writes borrow from a reserve pool of
+// EEPRWL_PRIORITY_POOL writes once their budget is used up. The pool
+// is refilled every hour (tick functions). Shed and committed writes
+// are counted per class. 0 = off (all writes normal, no RAM).
+#ifndef EEPRWL_PRIORITY_POOL
+     #define EEPRWL_PRIORITY_POOL 0
+#endif
+
+// setPriority() / shedWrites() / committedWrites()
+#define EEPRWL_PRIO_LOW       0
+#define EEPRWL_PRIO_NORMAL    1
+#define EEPRWL_PRIO_CRITICAL  2
+
+// -----------------------------------------------------------
+// 16. METADATA RING
+// -----------------------------------------------------------
+// Magic ID, layout hash and overwrite counter of a partition are
+// written as one record (write count, CRC) into the next of
+// EEPRWL_META_RING slots at the partition start; the WLM bucket
+// states as one record into the next of 3 slots of the WLM area.
+// A format or a counter rollover wears one slot instead of always
+// the same cells. Changes the partition layout (format on the
+// switch). 0 = fixed cells. Max. 16.
+#ifndef EEPRWL_META_RING
+     #define EEPRWL_META_RING 0
+#endif
+#if EEPRWL_META_RING > 16
+     #error "EEPRWL_META_RING: max. 16 slots"
+#endif
+// Ring record: magic-id(1) + config-hash(1) + overwrite-counter(2) + write count(2) + CRC(1)
+#define META_REC  7
+// WLM ring record: bucket states(1) + sequence(1) + CRC(1)
+#define WLM_REC  3
+
+// -----------------------------------------------------------
+// 17. SECTOR RETIREMENT
+// -----------------------------------------------------------
+// Spare sectors per partition (behind the ring). A sector that fails
+// the verify after a write is retired: its ring position is mapped
+// to the next free spare (remap table in the partition header) and
+// the record is written again. Readers and the ring arithmetic are
+// unchanged, a partition degrades only after all spares are used.
+// Changes the partition layout (format on the switch). 0 = off.
+// Max. 8. RAM: 2 * EEPRWL_SPARE_SECTORS + 1 bytes.
+#ifndef EEPRWL_SPARE_SECTORS
+     #define EEPRWL_SPARE_SECTORS 0
+#endif
+#if EEPRWL_SPARE_SECTORS > 8
+     #error "EEPRWL_SPARE_SECTORS: max. 8 spare sectors"
+#endif
+
+// -----------------------------------------------------------
+// 18. SECTOR ECC
+// -----------------------------------------------------------
+// 1 = every sector carries a SEC-DED check word (ECC_LEN bytes,
+// see EEProm_Safe_Wear_Level_Checksum.h) over payload, counter and
+// timestamp. A sector that fails its checksum is corrected in the
+// read buffer if one bit is flipped (the corrected sector must
+// pass the checksum), the EEPROM is not written. Changes the
+// sector layout (format on the switch). 0 = off.
+#ifndef EEPRWL_ECC
+     #define EEPRWL_ECC 0
+#endif
+#define ECC_LEN  ((EEPRWL_ECC > 0) ? 2 : 0)
+
+// -----------------------------------------------------------
+// 19. DELTA ENCODING
+// -----------------------------------------------------------
+// Partitions with handle 0 .. EEPRWL_DELTA-1 (max. 8) can store
+// records larger than their payload (setDelta()): write() stores
+// the byte runs changed since the previous record in one sector
+// (delta), periodically or when the runs do not fit the whole
+// record in consecutive sectors (keyframe). read(0, ...) rebuilds
+// the newest record. A small payload gives many sectors.
+// RAM: EEPRWL_DELTA * (EEPRWL_DELTA_SIZE + 4) + 2 bytes. 0 = off.
+#ifndef EEPRWL_DELTA
+     #define EEPRWL_DELTA 0
+#endif
+#if EEPRWL_DELTA > 8
+     #error "EEPRWL_DELTA: max. 8 partitions"
+#endif
+// Largest record of a delta partition (max. 255 bytes)
+#ifndef EEPRWL_DELTA_SIZE
+     #define EEPRWL_DELTA_SIZE 32
+#endif
+#if EEPRWL_DELTA_SIZE > 255
+     #error "EEPRWL_DELTA_SIZE: max. 255 bytes"
+#endif
+// First payload byte of a keyframe sector (bits 0-6: chunk index), 0 = delta
+#define DELTA_KEY  0x80
+
+#endif // EEPROM_SAFE_WEAR_LEVEL_MACROS_H
 
@@ -0,0 +1,160 @@
+#ifndef EEPROM_SAFE_WEAR_LEVEL_PARTITION_H
+#define EEPROM_SAFE_WEAR_LEVEL_PARTITION_H
+
+// -----------------------------------------------------------
+// COMPILE-TIME PARTITION (included by EEProm_Safe_Wear_Level.h)
+// -----------------------------------------------------------
+// EEPromPartition<Start, Size, Payload, CntLen, MemSize, PageSize, TimeLen>
+// Fixed layout of one partition: sector count, sector addresses,
+// counter limit and wrap math are constexpr, layout errors stop
+// the compilation (static_assert). The calls are forwarded to the
+// engine; the handle switch uses the constant geometry.
+//
+// Usage:
+//   typedef EEPromPartition<0, 256, sizeof(Record)> LogLayout;
+//   LogLayout logPart(EEPRWL, HANDLE1);
+//   static_assert(EEPRWL_disjoint<LogLayout, CfgLayout>(), "overlap");
+//   setup(): logPart.config(20); ...
+//
+// MemSize : EEPROM size for the check against the WLM bucket area
+//           (default EEPRWL_MEM_SIZE, 0 = no check, e.g. external EEPROM)
+// PageSize: page size of the storage backend (0 = no pages)
+// TimeLen : timestamp bytes per record (0 = none, see findByTime())
+//
+// Dynamic layouts use config() of EEProm_Safe_Wear_Level directly.
+
+template <uint16_t Start, uint16_t Size, uint8_t Payload, uint8_t CntLen = 3,
+          uint16_t MemSize = EEPRWL_MEM_SIZE, uint16_t PageSize = 0, uint8_t TimeLen = 0>
+class EEPromPartition {
+    public:
+      // --- CONSTANT GEOMETRY ---
+      static constexpr uint16_t start = Start;
+      static constexpr uint16_t end = Start + Size;          // first byte after the partition
+      static constexpr uint8_t  payload = Payload;
+      static constexpr uint8_t  counterLength = CntLen;
+      static constexpr uint8_t  timeLength = TimeLen;
+      static constexpr uint16_t sectorSize = Payload + CntLen + TimeLen + ECC_LEN + CRC_LEN;
+      static constexpr uint16_t sectors = (Size >= METADATA_SIZE + sectorSize)
+          ? EEProm_Safe_Wear_Level::sectorCount(Start, Size, sectorSize, PageSize) : 0;
+      static constexpr uint32_t maxCounter = EEProm_Safe_Wear_Level::counterLimit(CntLen, sectors ? sectors : 1);
+      static constexpr uint16_t hintInterval = EEProm_Safe_Wear_Level::hintInterval(sectors);
+      // Counter restarts at 1 after maxCounter (otherwise: status 3)
+      static constexpr bool rollover = maxCounter >= 2UL * sectors;
+
+      // Ring arithmetic
+      static constexpr uint16_t next(uint16_t sector) { return (sector + 1 >= sectors) ? 0 : sector + 1; }
+      static constexpr uint16_t previous(uint16_t sector) { return (sector == 0) ? sectors - 1 : sector - 1; }
+      // Physical sector of a logical counter (after format and rollover: counter 1 in sector 0)
+      static constexpr uint16_t sectorOf(uint32_t counter) { return (counter - 1) % sectors; }
+      // EEPROM address of a sector (same placement as the engine, a retired sector is not mapped
+      // to its spare: EEPRWL_SPARE_SECTORS)
+      static constexpr uint16_t sectorAddress(uint16_t sector) {
+          return (PageSize < sectorSize) ? Start + METADATA_SIZE + sector * sectorSize
+               : EEProm_Safe_Wear_Level::pageBase(Start, PageSize) + (sector / (PageSize / sectorSize)) * PageSize
+                 + (sector % (PageSize / sectorSize)) * sectorSize;
+      }
+
+      // --- LAYOUT CHECKS ---
+      static_assert(Payload >= 1, "EEPromPartition: payload size must be at least 1 byte");
+      static_assert(CntLen >= 1 && CntLen <= 4, "EEPromPartition: counter length must be 1 to 4 bytes");
+      static_assert(TimeLen <= 4, "EEPromPartition: timestamp length must be 0 to 4 bytes");
+      static_assert(sectors >= 1, "EEPromPartition: size too small for the metadata and one sector");
+      static_assert((uint32_t)Start + Size <= 0xFFFF, "EEPromPartition: partition exceeds the address range");
+      static_assert(MemSize == 0 || (uint32_t)Start + Size <= (uint32_t)MemSize - WLM_SIZE - MIGRATE_JOB_SIZE,
+                    "EEPromPartition: partition overlaps the WLM bucket area (and migration job) at the end of the EEPROM");
+
+      EEPromPartition(EEProm_Safe_Wear_Level& engine, uint8_t handle) : _engine(engine), _handle(handle) {}
+
+      // Returns: Overwrite number of the partition, 0 if the backend does not match the layout
+      uint16_t config(uint8_t budgetCycles = 20) {
+          uint16_t result = _engine.config(Start, Size, Payload, CntLen, budgetCycles, _handle, TimeLen);
+          if (_engine.getCtrlData(8, _handle) != sectors) return 0;
+          return result;
+      }
+
+      // --- FORWARDING API ---
+      bool initialize(bool forceFormat) { select(); return _engine.initialize(forceFormat, _handle); }
+
+      template <typename T>
+      bool write(const T& value, bool onlyIfChanged = false) {
+          static_assert(sizeof(T) <= Payload, "EEPromPartition: type larger than the payload");
+          select(); return _engine.write(value, _handle, onlyIfChanged);
+      }
+      bool write(const char* value, bool onlyIfChanged = false) { select(); return _engine.write(value, _handle, onlyIfChanged); }
+
+      template <typename T>
+      bool read(uint8_t ReadMode, T& value) { select(); return _engine.read(ReadMode, value, _handle); }
+      bool read(uint8_t ReadMode, char* value, size_t maxSize = 0) { select(); return _engine.read(ReadMode, value, _handle, maxSize); }
+
+      template <typename T>
+      bool readByCounter(uint32_t counter, T& value) { select(); return _engine.readByCounter(counter, value, _handle); }
+      template <typename T>
+      bool readRelative(int32_t offset, T& value) { select(); return _engine.readRelative(offset, value, _handle); }
+
+      template <typename T>
+      uint16_t writeBatch(const T* records, uint16_t count) {
+          static_assert(sizeof(T) <= Payload, "EEPromPartition: type larger than the payload");
+          select(); return _engine.writeBatch(records, count, _handle);
+      }
+      template <typename T>
+      bool writeAsync(const T& value) {
+          static_assert(sizeof(T) <= Payload, "EEPromPartition: type larger than the payload");
+          select(); return _engine.writeAsync(value, _handle);
+      }
+
+      uint16_t forEachRecord(uint8_t from, uint16_t count, uint8_t direction, EEPRWL_Visitor visitor, void* context = 0) {
+          select(); return _engine.forEachRecord(from, count, direction, visitor, _handle, context);
+      }
+      bool findByTime(uint32_t time) { select(); return _engine.findByTime(time, _handle); }
+      uint16_t forEachInTimeRange(uint32_t timeFrom, uint32_t timeTo, EEPRWL_Visitor visitor, void* context = 0) {
+          select(); return _engine.forEachInTimeRange(timeFrom, timeTo, visitor, _handle, context);
+      }
+      uint32_t recordTime() { select(); return _engine.recordTime(_handle); }
+      bool findNewestData() { select(); return _engine.findNewestData(_handle); }
+      bool findOldestData() { select(); return _engine.findOldestData(_handle); }
+      uint32_t getCtrlData(uint8_t offs) { select(); return _engine.getCtrlData(offs, _handle); }
+
+      uint8_t handle() const { return _handle; }
+
+    private:
+      EEProm_Safe_Wear_Level& _engine;
+      uint8_t _handle;
+
+      // Handle switch without recalculation of the geometry
+      void select() { _engine.selectPartition(_handle, CntLen + TimeLen + ECC_LEN + CRC_LEN, sectorSize, maxCounter, hintInterval); }
+};
+
+// Definitions of the constants (ODR use, e.g. reference parameters)
+template <uint16_t S, uint16_t Z, uint8_t P, uint8_t C, uint16_t M, uint16_t G, uint8_t L>
+constexpr uint16_t EEPromPartition<S, Z, P, C, M, G, L>::start;
+template <uint16_t S, uint16_t Z, uint8_t P, uint8_t C, uint16_t M, uint16_t G, uint8_t L>
+constexpr uint16_t EEPromPartition<S, Z, P, C, M, G, L>::end;
+template <uint16_t S, uint16_t Z, uint8_t P, uint8_t C, uint16_t M, uint16_t G, uint8_t L>
+constexpr uint8_t EEPromPartition<S, Z, P, C, M, G, L>::payload;
+template <uint16_t S, uint16_t Z, uint8_t P, uint8_t C, uint16_t M, uint16_t G, uint8_t L>
+constexpr uint8_t EEPromPartition<S, Z, P, C, M, G, L>::counterLength;
+template <uint16_t S, uint16_t Z, uint8_t P, uint8_t C, uint16_t M, uint16_t G, uint8_t L>
+constexpr uint8_t EEPromPartition<S, Z, P, C, M, G, L>::timeLength;
+template <uint16_t S, uint16_t Z, uint8_t P, uint8_t C, uint16_t M, uint16_t G, uint8_t L>
+constexpr uint16_t EEPromPartition<S, Z, P, C, M, G, L>::sectorSize;
+template <uint16_t S, uint16_t Z, uint8_t P, uint8_t C, uint16_t M, uint16_t G, uint8_t L>
+constexpr uint16_t EEPromPartition<S, Z, P, C, M, G, L>::sectors;
+template <uint16_t S, uint16_t Z, uint8_t P, uint8_t C, uint16_t M, uint16_t G, uint8_t L>
+constexpr uint32_t EEPromPartition<S, Z, P, C, M, G, L>::maxCounter;
+template <uint16_t S, uint16_t Z, uint8_t P, uint8_t C, uint16_t M, uint16_t G, uint8_t L>
+constexpr uint16_t EEPromPartition<S, Z, P, C, M, G, L>::hintInterval;
+
+// ----------------------------------------------------------------------------------------------------
+
+// true if no two of the partition layouts overlap:
+// static_assert(EEPRWL_disjoint<PartA, PartB, PartC>(), "partition overlap");
+template <typename A>
+constexpr bool EEPRWL_disjoint() { return true; }
+
+template <typename A, typename B, typename... R>
+constexpr bool EEPRWL_disjoint() {
+    return (A::end <= B::start || B::end <= A::start)
+        && EEPRWL_disjoint<A, R...>() && EEPRWL_disjoint<B, R...>();
+}
+
+#endif // EEPROM_SAFE_WEAR_LEVEL_PARTITION_H
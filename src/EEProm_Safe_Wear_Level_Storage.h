@@ -0,0 +1,121 @@
+#ifndef EEPROM_SAFE_WEAR_LEVEL_STORAGE_H
+#define EEPROM_SAFE_WEAR_LEVEL_STORAGE_H
+
+// -----------------------------------------------------------
+// STORAGE BACKENDS
+// -----------------------------------------------------------
+// All EEPROM accesses of the library (e_r / e_w / e_c and the
+// block macros e_rb / e_wb) go through an EEPRWL_Storage object.
+// The wear-leveling, CRC and WLM engine is therefore independent
+// of the memory: internal EEPROM, external I2C/SPI EEPROM, FRAM or
+// RAM (host builds).
+//
+// A backend implements read(), write() and length(). commit(),
+// pageSize() and the block functions are optional; a backend
+// overrides them to use its fastest transfer path (e.g. one bus
+// transaction per block / page).
+//
+// Backends in this library:
+// EEPRWL_InternalEEPROM  : EEPROM.h of the core (default, Arduino only)
+// EEPRWL_RamStorage      : RAM array (host builds, simulation)
+// EEPRWL_I2CEEPROM       : 24LCxx / FRAM, see EEProm_Safe_Wear_Level_I2C.h
+
+class EEPRWL_Storage {
+    public:
+      virtual uint8_t  read(uint16_t addr) = 0;
+      virtual void     write(uint16_t addr, uint8_t value) = 0;
+      virtual uint16_t length() = 0;
+      virtual void     commit() {}
+      // Page size of the memory in bytes (0 = no pages). The library places the
+      // sectors so that they do not straddle a page and writes them in one burst.
+      virtual uint16_t pageSize() { return 0; }
+      // Asynchronous write (asyncStep()): true if the last write cycle is finished,
+      // so the next byte is written without waiting
+      virtual bool     ready() { return true; }
+      // EEPROM-ready interrupt on/off (EEPRWL_ASYNC_ISR)
+      virtual void     readyInterrupt(bool enable) { (void)enable; }
+
+      // Block transfer (default: byte by byte)
+      virtual void readBlock(uint16_t addr, uint8_t* buffer, uint16_t len) {
+          for (uint16_t i = 0; i < len; i++) buffer[i] = read(addr + i);
+      }
+      virtual void writeBlock(uint16_t addr, const uint8_t* buffer, uint16_t len) {
+          for (uint16_t i = 0; i < len; i++) write(addr + i, buffer[i]);
+      }
+};
+
+// ----------------------------------------------------------------------------------------------------
+
+#if defined(ARDUINO)
+// Internal EEPROM of the microcontroller (EEPROM.h)
+class EEPRWL_InternalEEPROM : public EEPRWL_Storage {
+    public:
+      uint8_t  read(uint16_t addr) { return EEPROM.read(addr); }
+      void     write(uint16_t addr, uint8_t value) { EEPROM.write(addr, value); }
+      uint16_t length() { return EEPROM.length(); }
+#if defined(ESP8266) || defined(ESP32)
+      void     commit() { EEPROM.commit(); }
+#endif
+#if defined(__AVR__)
+      bool     ready() { return eeprom_is_ready(); }
+      void     readyInterrupt(bool enable) {
+          if (enable) EECR |= (1 << EERIE);
+          else EECR &= ~(1 << EERIE);
+      }
+#endif
+};
+
+// Default backend of the constructor without storage parameter
+extern EEPRWL_InternalEEPROM EEPRWL_internalEEPROM;
+#endif
+
+// ----------------------------------------------------------------------------------------------------
+
+// RAM array as EEPROM (host builds, unit tests, simulation)
+// With pageSize > 0 it models a page-write EEPROM: a block write is split at
+// page boundaries and every page part is one write cycle. The counters show the
+// number of bus transactions / write cycles the library causes.
+// busyPolls models the ready flag: after a write cycle ready() returns false
+// for busyPolls queries (asynchronous write engine).
+class EEPRWL_RamStorage : public EEPRWL_Storage {
+    public:
+      EEPRWL_RamStorage(uint8_t* memory, uint16_t size, uint16_t pageSize = 0)
+          : readTransfers(0), writeCycles(0), busyPolls(0), _mem(memory), _size(size), _page(pageSize), _busy(0) {}
+
+      uint8_t  read(uint16_t addr) { readTransfers++; return _mem[addr]; }
+      void     write(uint16_t addr, uint8_t value) { writeCycles++; _busy = busyPolls; _mem[addr] = value; }
+      uint16_t length() { return _size; }
+      uint16_t pageSize() { return _page; }
+      bool     ready() {
+          if (_busy == 0) return true;
+          _busy--;
+          return false;
+      }
+
+      void readBlock(uint16_t addr, uint8_t* buffer, uint16_t len) {
+          readTransfers++;
+          memcpy(buffer, &_mem[addr], len);
+      }
+
+      void writeBlock(uint16_t addr, const uint8_t* buffer, uint16_t len) {
+          while (len > 0) {
+              uint16_t n = len;
+              if (_page > 0 && n > _page - (addr % _page)) n = _page - (addr % _page);
+              writeCycles++; _busy = busyPolls;
+              memcpy(&_mem[addr], buffer, n);
+              addr += n; buffer += n; len -= n;
+          }
+      }
+
+      uint32_t readTransfers;
+      uint32_t writeCycles;
+      uint16_t busyPolls;
+
+    private:
+      uint8_t* _mem;
+      uint16_t _size;
+      uint16_t _page;
+      uint16_t _busy;
+};
+
+#endif // EEPROM_SAFE_WEAR_LEVEL_STORAGE_H